@@ -27,6 +27,7 @@
 #ifndef NODE_POOL_BASE_HPP
 #define NODE_POOL_BASE_HPP
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <vector>
@@ -134,6 +135,33 @@ struct murmur_hasher32_t {
 	}
 };
 
+namespace detail {
+
+/**
+ * @brief Turns a children-first pool (children appended before their
+ * parents) into the root-first layout, as `node_pool_builder::build` does.
+ *
+ * The nodes are reversed and every child index `c` becomes `n - c + 1`,
+ * so the root is node 0 and children follow their parents.
+ *
+ * @param root Index of the root; if it was deduplicated onto an earlier
+ *        node, a copy is appended first so it ends up at index 0.
+ */
+inline void finalize_children_first(std::vector<node_t<int>>& nodes, int root) {
+  if (size_t(root) + 1 != nodes.size())
+    nodes.push_back(nodes[root]);
+  std::reverse(nodes.begin(), nodes.end());
+  const int n = int(nodes.size());
+  for (auto& node : nodes) {
+    for (auto& child : node.children) {
+      if (child > 0)
+        child = n - child + 1;
+    }
+  }
+}
+
+} // namespace detail
+
 }
 
 namespace std {
@@ -167,6 +195,12 @@ private:
   friend class node_pool_editor;
   friend class node_pool_builder;
   friend class node_pool_traversal;
+  friend class node_pool_voxelizer;
+  friend class node_pool_tiler;
+  friend class node_pool_cow_editor;
+  friend class node_pool_gc;
+  friend class node_pool_defrag;
+  friend class node_pool_sequence;
 
 public:
   /// Default destructor.
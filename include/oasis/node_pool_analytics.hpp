@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_ANALYTICS_HPP
+#define NODE_POOL_ANALYTICS_HPP
+
+#include <oasis/node_pool.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace oasis {
+
+/**
+ * @struct pool_level_stats_t
+ * @brief Statistics of the nodes at one level of a pool.
+ */
+struct pool_level_stats_t {
+  size_t   nodes          = 0; ///< Unique nodes.
+  double   tree_nodes     = 0; ///< Nodes the level would hold without deduplication.
+  size_t   inner_children = 0; ///< Child slots referencing a node.
+  size_t   leaf_children  = 0; ///< Child slots holding a leaf value.
+  size_t   empty_children = 0; ///< Empty child slots.
+  uint64_t indegree_sum   = 0; ///< Parent references to the level's nodes.
+  uint32_t indegree_max   = 0;
+
+  /// Bytes under each encoding (see `pool_report_t`).
+  size_t bytes_dense  = 0;
+  size_t bytes_sparse = 0;
+  size_t bytes_mask   = 0;
+  size_t bytes_varint = 0;
+};
+
+/**
+ * @struct pool_report_t
+ * @brief Where a pool's nodes and memory go.
+ *
+ * Encodings compared per level:
+ * - dense: the current 8 x int32 node (32 bytes).
+ * - sparse: 1 byte child mask plus 4 bytes per non-empty child.
+ * - mask: 1 byte child mask, 1 byte leaf mask and 4 bytes per inner
+ *   child; leaf values are dropped (geometry only).
+ * - varint: sparse, with each value stored as a zigzag varint (inner
+ *   children as the index delta from their parent).
+ */
+struct pool_report_t {
+  std::vector<pool_level_stats_t> levels;
+  std::array<size_t, 9>           occupancy{}; ///< Nodes by number of non-empty children.
+  size_t                          nodes       = 0;
+  size_t                          unreachable = 0; ///< Nodes no parent references (other than the root).
+  uint32_t                        indegree_max = 0;
+
+  /// Nodes the pool would hold as a tree.
+  inline double tree_nodes() const {
+    double n = 0;
+    for (const auto& l : levels) n += l.tree_nodes;
+    return n;
+  }
+
+  /// Average number of parents per non-root node.
+  inline double average_indegree() const {
+    uint64_t sum = 0;
+    size_t n = 0;
+    for (size_t l = 1; l < levels.size(); ++l) {
+      sum += levels[l].indegree_sum;
+      n += levels[l].nodes;
+    }
+    return n ? double(sum) / n : 0.0;
+  }
+};
+
+namespace detail {
+
+inline size_t varint_bytes(uint64_t v) {
+  return std::max<size_t>(1, (std::bit_width(v) + 6) / 7);
+}
+
+inline uint64_t zigzag(int64_t v) {
+  return (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+}
+
+} // namespace detail
+
+/**
+ * @brief Analyzes a pool (root at index 0).
+ *
+ * Levels and tree sizes come from one forward pass over the parent-first
+ * node order the builders produce (a breadth-first walk is used if the
+ * pool is not in that order). Everything else is gathered in one pass
+ * split across threads.
+ *
+ * @param threads Worker threads (0 = hardware concurrency).
+ */
+inline pool_report_t analyze_pool(std::span<const node_t<int>> nodes, uint32_t threads = 0) {
+  pool_report_t report;
+  report.nodes = nodes.size();
+  if (nodes.empty()) return report;
+
+  // Levels (-1 = unreachable) and path counts
+  const size_t n = nodes.size();
+  std::vector<int32_t> level(n, -1);
+  std::vector<double> paths(n, 0.0);
+  level[0] = 0;
+  paths[0] = 1.0;
+  bool ordered = true;
+  for (size_t i = 0; i < n && ordered; ++i) {
+    if (level[i] < 0) continue;
+    for (int child : nodes[i].children) {
+      if (child <= 0) continue;
+      if (size_t(child - 1) <= i) {
+        ordered = false;
+        break;
+      }
+      level[child - 1] = level[i] + 1;
+      paths[child - 1] += paths[i];
+    }
+  }
+  if (!ordered) {
+    std::fill(level.begin(), level.end(), -1);
+    std::fill(paths.begin(), paths.end(), 0.0);
+    level[0] = 0;
+    paths[0] = 1.0;
+    std::vector<uint32_t> frontier{0}, next;
+    while (!frontier.empty()) {
+      next.clear();
+      for (uint32_t i : frontier) {
+        for (int child : nodes[i].children) {
+          if (child <= 0) continue;
+          if (level[child - 1] < 0) {
+            level[child - 1] = level[i] + 1;
+            next.push_back(uint32_t(child - 1));
+          }
+          paths[child - 1] += paths[i];
+        }
+      }
+      frontier.swap(next);
+    }
+  }
+  const int32_t levels = *std::max_element(level.begin(), level.end()) + 1;
+
+  // Parallel pass with per-thread accumulators
+  std::vector<std::atomic<uint32_t>> indegree(n);
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = uint32_t(std::min<size_t>(threads, (n + 4095) / 4096));
+  std::vector<pool_report_t> parts(threads);
+
+  auto work = [&](uint32_t part) {
+    pool_report_t& r = parts[part];
+    r.levels.resize(levels);
+    for (size_t i = n * part / threads; i < n * (part + 1) / threads; ++i) {
+      if (level[i] < 0) {
+        ++r.unreachable;
+        continue;
+      }
+      auto& l = r.levels[level[i]];
+      ++l.nodes;
+      l.tree_nodes += paths[i];
+      l.bytes_dense += sizeof(node_t<int>);
+      l.bytes_sparse += 1;
+      l.bytes_mask += 2;
+      l.bytes_varint += 1;
+      uint32_t occupied = 0;
+      for (int child : nodes[i].children) {
+        if (child == 0) {
+          ++l.empty_children;
+          continue;
+        }
+        ++occupied;
+        l.bytes_sparse += 4;
+        if (child > 0) {
+          ++l.inner_children;
+          l.bytes_mask += 4;
+          l.bytes_varint += detail::varint_bytes(detail::zigzag(int64_t(child - 1) - int64_t(i)));
+          indegree[child - 1].fetch_add(1, std::memory_order_relaxed);
+        } else {
+          ++l.leaf_children;
+          l.bytes_varint += detail::varint_bytes(detail::zigzag(child));
+        }
+      }
+      ++r.occupancy[occupied];
+    }
+  };
+  std::vector<std::thread> pool;
+  for (uint32_t part = 1; part < threads; ++part)
+    pool.emplace_back(work, part);
+  work(0);
+  for (auto& th : pool) th.join();
+
+  report.levels.resize(levels);
+  for (const auto& r : parts) {
+    report.unreachable += r.unreachable;
+    for (size_t k = 0; k < 9; ++k)
+      report.occupancy[k] += r.occupancy[k];
+    for (int32_t l = 0; l < levels; ++l) {
+      auto& dst = report.levels[l];
+      const auto& src = r.levels[l];
+      dst.nodes += src.nodes;
+      dst.tree_nodes += src.tree_nodes;
+      dst.inner_children += src.inner_children;
+      dst.leaf_children += src.leaf_children;
+      dst.empty_children += src.empty_children;
+      dst.bytes_dense += src.bytes_dense;
+      dst.bytes_sparse += src.bytes_sparse;
+      dst.bytes_mask += src.bytes_mask;
+      dst.bytes_varint += src.bytes_varint;
+    }
+  }
+  for (size_t i = 1; i < n; ++i) {
+    if (level[i] < 0) continue;
+    const uint32_t d = indegree[i].load(std::memory_order_relaxed);
+    auto& l = report.levels[level[i]];
+    l.indegree_sum += d;
+    l.indegree_max = std::max(l.indegree_max, d);
+    report.indegree_max = std::max(report.indegree_max, d);
+  }
+  return report;
+}
+
+/**
+ * @brief Writes a report as plain text tables.
+ */
+inline void write_pool_report(std::ostream& out, const pool_report_t& r) {
+  out << "Nodes: " << r.nodes << " (unreachable " << r.unreachable << ")\n";
+  out << "Tree nodes: " << r.tree_nodes() << " (dedup ratio " << (r.nodes ? r.tree_nodes() / r.nodes : 0.0) << "x)\n";
+  out << "In-degree: average " << r.average_indegree() << ", max " << r.indegree_max << "\n";
+  out << "Occupancy histogram (children: nodes):";
+  for (size_t k = 0; k < r.occupancy.size(); ++k)
+    out << " " << k << ":" << r.occupancy[k];
+  out << "\n";
+  out << "level, nodes, tree nodes, inner, leaf, empty, avg in-degree, max in-degree, "
+         "dense bytes, sparse bytes, mask bytes, varint bytes\n";
+  pool_level_stats_t total;
+  for (size_t l = 0; l < r.levels.size(); ++l) {
+    const auto& s = r.levels[l];
+    out << l << ", " << s.nodes << ", " << s.tree_nodes << ", " << s.inner_children << ", " 
+        << s.leaf_children << ", " << s.empty_children << ", " 
+        << (s.nodes ? double(s.indegree_sum) / s.nodes : 0.0) << ", " << s.indegree_max << ", " 
+        << s.bytes_dense << ", " << s.bytes_sparse << ", " << s.bytes_mask << ", " << s.bytes_varint << "\n";
+    total.bytes_dense += s.bytes_dense;
+    total.bytes_sparse += s.bytes_sparse;
+    total.bytes_mask += s.bytes_mask;
+    total.bytes_varint += s.bytes_varint;
+  }
+  out << "total bytes: dense " << total.bytes_dense << ", sparse " << total.bytes_sparse 
+      << ", mask " << total.bytes_mask << ", varint " << total.bytes_varint << "\n";
+}
+
+} // namespace oasis
+
+#endif // NODE_POOL_ANALYTICS_HPP
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_BEAM_HPP
+#define NODE_POOL_BEAM_HPP
+
+#include <oasis/node_pool_fixed_traversal.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @struct camera_t
+ * @brief Pinhole camera generating one primary ray per pixel.
+ */
+struct camera_t {
+  glm::vec3 eye     = glm::vec3(0.0f);
+  glm::vec3 forward = glm::vec3(0.0f, 0.0f, -1.0f);
+  glm::vec3 up      = glm::vec3(0.0f, 1.0f, 0.0f);
+  float     fov_y   = 1.0f;  ///< Vertical field of view in radians.
+  uint32_t  width   = 640;
+  uint32_t  height  = 480;
+
+  /// Unit direction through image position (x, y) in pixels; (0, 0) is the top-left corner.
+  inline glm::vec3 direction(float x, float y) const {
+    const glm::vec3 f = glm::normalize(forward);
+    const glm::vec3 r = glm::normalize(glm::cross(f, up));
+    const glm::vec3 u = glm::cross(r, f);
+    const float h = std::tan(fov_y * 0.5f);
+    const float w = h * float(width) / float(height);
+    return glm::normalize(f + r * ((2.0f * x / float(width) - 1.0f) * w) + u * ((1.0f - 2.0f * y / float(height)) * h));
+  }
+};
+
+/**
+ * @brief Finds a safe starting distance for the primary rays of each pixel tile.
+ *
+ * Each tile's rays are bounded by a cone around its center ray. The pool
+ * is searched for non-empty cells touching the cone, and the closest
+ * distance from the eye to any of them is returned: no ray of the tile
+ * can hit a voxel before it. Cells are refined only while they are wider
+ * than the cone at their distance, so the search stays in the upper
+ * levels that all rays of the tile share.
+ *
+ * @param tile Tile edge in pixels.
+ * @return One distance per tile (row-major), infinity if no ray of the tile can hit.
+ */
+inline std::vector<float> beam_prepass(std::span<const node_t<int>> nodes, const pool_frame_t& frame,
+                                       const camera_t& camera, uint32_t tile = 8) {
+  const uint32_t tiles_x = (camera.width + tile - 1) / tile;
+  const uint32_t tiles_y = (camera.height + tile - 1) / tile;
+  std::vector<float> out(size_t(tiles_x) * tiles_y, std::numeric_limits<float>::infinity());
+  if (nodes.empty()) return out;
+
+  struct entry_t { int node; uint32_t level; glm::vec3 corner; float size; };
+  std::vector<entry_t> stack;
+
+  for (uint32_t ty = 0; ty < tiles_y; ++ty) {
+    for (uint32_t tx = 0; tx < tiles_x; ++tx) {
+      // Cone through the tile's corner rays
+      const float x0 = float(tx * tile), x1 = float(std::min((tx + 1) * tile, camera.width));
+      const float y0 = float(ty * tile), y1 = float(std::min((ty + 1) * tile, camera.height));
+      const glm::vec3 axis = camera.direction((x0 + x1) * 0.5f, (y0 + y1) * 0.5f);
+      float cos_a = 1.0f;
+      for (glm::vec2 c : {glm::vec2(x0, y0), glm::vec2(x1, y0), glm::vec2(x0, y1), glm::vec2(x1, y1)})
+        cos_a = std::min(cos_a, glm::dot(axis, camera.direction(c.x, c.y)));
+      const float sin_a = std::sqrt(std::max(0.0f, 1.0f - cos_a * cos_a));
+      const float tan_a = sin_a / std::max(cos_a, 1e-6f);
+
+      auto touches = [&](glm::vec3 corner, float size) {
+        const float radius = size * 0.8660254f; // bounding sphere
+        const glm::vec3 v = corner + size * 0.5f - camera.eye;
+        const float h = glm::dot(v, axis);
+        const float p = glm::length(v - axis * h);
+        return p * cos_a - h * sin_a <= radius;
+      };
+      auto distance = [&](glm::vec3 corner, float size) {
+        const glm::vec3 q = glm::clamp(camera.eye, corner, corner + size);
+        return glm::length(q - camera.eye);
+      };
+
+      float best = std::numeric_limits<float>::infinity();
+      stack.clear();
+      if (touches(frame.corner, frame.size))
+        stack.push_back({0, 0, frame.corner, frame.size});
+      while (!stack.empty()) {
+        const entry_t e = stack.back();
+        stack.pop_back();
+        const float dist = distance(e.corner, e.size);
+        if (dist >= best) continue;
+
+        // Stop refining once the cell is narrower than the beam
+        if (e.size < 2.0f * tan_a * std::max(dist, 1e-6f)) {
+          best = dist;
+          continue;
+        }
+        const float h = e.size * 0.5f;
+        for (uint32_t i = 0; i < 8; ++i) {
+          const int child = nodes[e.node].children[i];
+          if (child == 0) continue;
+          const glm::vec3 c = e.corner + child_offset(i) * h;
+          if (!touches(c, h)) continue;
+          if (child < 0 || e.level + 1 >= frame.depth)
+            best = std::min(best, distance(c, h));
+          else
+            stack.push_back({child - 1, e.level + 1, c, h});
+        }
+      }
+      out[size_t(ty) * tiles_x + tx] = best;
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Traces one primary ray per pixel.
+ *
+ * With `tile` > 0 a beam prepass runs first: tiles it proves empty are
+ * skipped and every other ray starts at its tile's safe distance.
+ *
+ * @param tile Beam tile edge in pixels, 0 to trace every ray from the eye.
+ * @param threads Worker threads (0 = hardware concurrency).
+ * @return Hit distance per pixel (row-major), -1 for misses.
+ */
+inline std::vector<float> trace_primary(std::span<const node_t<int>> nodes, const pool_frame_t& frame,
+                                        const camera_t& camera, float max_dist, uint32_t tile = 8,
+                                        uint32_t threads = 0) {
+  std::vector<float> depth(size_t(camera.width) * camera.height, -1.0f);
+  const uint32_t step = tile > 0 ? tile : 8;
+  const uint32_t tiles_x = (camera.width + step - 1) / step;
+  const uint32_t tiles_y = (camera.height + step - 1) / step;
+  const std::vector<float> start = tile > 0 ? beam_prepass(nodes, frame, camera, tile)
+                                            : std::vector<float>(size_t(tiles_x) * tiles_y, 0.0f);
+
+  std::atomic<uint32_t> next{0};
+  auto work = [&]() {
+    for (uint32_t t = next++; t < tiles_x * tiles_y; t = next++) {
+      // Back off a little so the start point stays outside the first hit cell
+      const float t0 = start[t] == 0.0f ? 0.0f : start[t] * 0.999f;
+      if (t0 >= max_dist) continue;
+      const uint32_t tx = t % tiles_x, ty = t / tiles_x;
+      for (uint32_t y = ty * step; y < std::min((ty + 1) * step, camera.height); ++y) {
+        for (uint32_t x = tx * step; x < std::min((tx + 1) * step, camera.width); ++x) {
+          const glm::vec3 d = camera.direction(float(x) + 0.5f, float(y) + 0.5f);
+          if (auto hit = query_ray_fixed(nodes, frame, camera.eye + d * t0, d, max_dist - t0))
+            depth[size_t(y) * camera.width + x] = *hit + t0;
+        }
+      }
+    }
+  };
+
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::thread> pool;
+  for (uint32_t i = 1; i < threads; ++i)
+    pool.emplace_back(work);
+  work();
+  for (auto& th : pool) th.join();
+  return depth;
+}
+
+} // namespace oasis
+
+#endif // NODE_POOL_BEAM_HPP
@@ -0,0 +1,378 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_COMPACT_HPP
+#define NODE_POOL_COMPACT_HPP
+
+#include <oasis/node_pool_fixed_traversal.hpp>
+#include <oasis/node_pool_queries.hpp>
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace oasis {
+
+/**
+ * @class compact_pool_view
+ * @brief Reads nodes straight from the compact pool encoding.
+ *
+ * Encoding, per node, byte-aligned and in node order:
+ * - 1 byte child mask (bit `slot` set for a non-empty child),
+ * - 1 byte leaf mask (subset of the child mask),
+ * - per inner child, in slot order, an LEB128 varint: the zigzagged
+ *   byte offset of the child relative to this node,
+ * - the leaf values as codes `-value - 1`: the first as varint
+ *   `code << 1 | uniform`, then (unless all leaves share it) one varint
+ *   per further leaf, in slot order.
+ *
+ * Child references are byte offsets, so a traversal follows them without
+ * any lookup, and the root is at offset 0. Offsets take the place of
+ * node indices in the `node_t<int>` child encoding (`child` returns
+ * offset + 1), which lets `fixed_walk` run on the encoding unchanged.
+ * Offsets must therefore fit an `int`: encodings are limited to
+ * `compact_pool::max_bytes`.
+ * The offset of every `block`-th node is kept in an index for access by
+ * node number (`node`).
+ *
+ * The view does not own the bytes: they may come from a `compact_pool`
+ * or from a mapped file.
+ */
+class compact_pool_view {
+public:
+  constexpr compact_pool_view() = default;
+
+  inline compact_pool_view(std::span<const uint8_t> bytes, std::span<const uint64_t> blocks, size_t nodes, uint32_t block)
+    : m_bytes(bytes.data()), m_blocks(blocks.data()), m_nodes(nodes), m_block(block) {}
+
+  inline size_t size() const { return m_nodes; }
+
+  inline bool empty() const { return m_nodes == 0; }
+
+  /// Child `slot` (0-7) of the node at byte `offset`: 0 empty, negative a leaf, positive child offset + 1.
+  inline int child(size_t offset, uint32_t slot) const {
+    const uint8_t* p = m_bytes + offset;
+    const uint32_t mask = p[0], leaves = p[1], inner = mask & ~leaves;
+    const uint32_t bit = 1u << slot, below = bit - 1;
+    if (!(mask & bit)) return 0;
+    if (inner & bit) {
+      p = skip_varints(p + 2, std::popcount(inner & below));
+      return int(int64_t(offset) + unzigzag(read_varint(p))) + 1;
+    }
+    p = skip_varints(p + 2, std::popcount(inner));
+    const uint64_t first = read_varint(p);
+    if ((first & 1) || !(leaves & below)) return -int(first >> 1) - 1;
+    p = skip_varints(p, std::popcount(leaves & below) - 1);
+    return -int(read_varint(p)) - 1;
+  }
+
+  /// Byte offset of node number `index`.
+  inline size_t offset_of(size_t index) const {
+    const uint8_t* p = m_bytes + m_blocks[index / m_block];
+    for (size_t i = index % m_block; i > 0; --i)
+      p = next_node(p);
+    return size_t(p - m_bytes);
+  }
+
+  /// Node number of the node at byte `offset`.
+  inline size_t index_of(size_t offset) const {
+    const size_t blocks = (m_nodes + m_block - 1) / m_block;
+    const size_t b = size_t(std::upper_bound(m_blocks, m_blocks + blocks, uint64_t(offset)) - m_blocks) - 1;
+    size_t index = b * m_block;
+    for (const uint8_t* p = m_bytes + m_blocks[b]; p < m_bytes + offset; p = next_node(p))
+      ++index;
+    return index;
+  }
+
+  /// Expands node number `index` (inner children as node numbers + 1).
+  inline node_t<int> node(size_t index) const {
+    const size_t offset = offset_of(index);
+    node_t<int> n;
+    for (uint32_t slot = 0; slot < 8; ++slot) {
+      const int c = child(offset, slot);
+      n.children[slot] = c > 0 ? int(index_of(size_t(c - 1))) + 1 : c;
+    }
+    return n;
+  }
+
+  static inline uint64_t read_varint(const uint8_t*& p) {
+    uint64_t v = 0;
+    for (uint32_t shift = 0;; shift += 7) {
+      const uint8_t b = *p++;
+      v |= uint64_t(b & 0x7f) << shift;
+      if (!(b & 0x80)) return v;
+    }
+  }
+
+private:
+  static inline int64_t unzigzag(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+  /// Skips `count` varints (a byte with the high bit clear ends one).
+  static inline const uint8_t* skip_varints(const uint8_t* p, int count) {
+    while (count > 0)
+      count -= !(*p++ & 0x80);
+    return p;
+  }
+
+  static inline const uint8_t* next_node(const uint8_t* p) {
+    const uint32_t mask = p[0], leaves = p[1];
+    p = skip_varints(p + 2, std::popcount(mask & ~leaves));
+    if (!leaves) return p;
+    const uint64_t first = read_varint(p);
+    return (first & 1) ? p : skip_varints(p, std::popcount(leaves) - 1);
+  }
+
+  const uint8_t*  m_bytes  = nullptr;
+  const uint64_t* m_blocks = nullptr;
+  size_t          m_nodes  = 0;
+  uint32_t        m_block  = 1;
+};
+
+/**
+ * @class compact_pool
+ * @brief A pool in the compact encoding, with its block offset index.
+ *
+ * File format: node count, block size, byte count, block offsets, bytes.
+ */
+class compact_pool {
+public:
+  /// Largest encoding: child offsets + 1 are returned as `int`.
+  static constexpr uint64_t max_bytes = INT_MAX;
+
+  inline compact_pool() = default;
+
+  /**
+   * @brief Encodes a node array (root at index 0).
+   *
+   * A depth-first layout (e.g. `depth_first_order`) keeps the child
+   * offsets short.
+   *
+   * Pools whose encoding would exceed `max_bytes` are not encoded: the
+   * result is empty.
+   *
+   * @param block Nodes per block offset entry.
+   */
+  inline explicit compact_pool(std::span<const node_t<int>> nodes, uint32_t block = 16) : m_block(std::max(1u, block)) {
+    m_nodes = nodes.size();
+
+    // A node's size depends on its children's offsets and the other way
+    // round: grow the reference widths until the layout is stable. Widths
+    // never shrink (a varint may be padded), so this terminates.
+    std::vector<uint8_t> widths(nodes.size() * 8, 1);
+    std::vector<uint64_t> offsets(nodes.size() + 1, 0);
+    std::vector<uint32_t> leaf_bytes(nodes.size(), 0);
+    for (size_t i = 0; i < nodes.size(); ++i)
+      leaf_bytes[i] = uint32_t(leaf_codes(nodes[i], nullptr));
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (size_t i = 0; i < nodes.size(); ++i) {
+        uint64_t size = 2 + leaf_bytes[i];
+        for (uint32_t slot = 0; slot < 8; ++slot) {
+          if (nodes[i].children[slot] > 0) size += widths[i * 8 + slot];
+        }
+        offsets[i + 1] = offsets[i] + size;
+      }
+      for (size_t i = 0; i < nodes.size(); ++i) {
+        for (uint32_t slot = 0; slot < 8; ++slot) {
+          const int child = nodes[i].children[slot];
+          if (child <= 0) continue;
+          const uint8_t w = uint8_t(varint_bytes(zigzag(int64_t(offsets[child - 1]) - int64_t(offsets[i]))));
+          if (w > widths[i * 8 + slot]) {
+            widths[i * 8 + slot] = w;
+            changed = true;
+          }
+        }
+      }
+    }
+
+    if (offsets.back() > max_bytes) {
+      m_nodes = 0;
+      return;
+    }
+
+    m_bytes.reserve(offsets.back());
+    m_blocks.reserve((nodes.size() + m_block - 1) / m_block);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (i % m_block == 0) m_blocks.push_back(m_bytes.size());
+      uint8_t mask = 0, leaves = 0;
+      for (uint32_t slot = 0; slot < 8; ++slot) {
+        const int child = nodes[i].children[slot];
+        if (child != 0) mask |= uint8_t(1u << slot);
+        if (child < 0) leaves |= uint8_t(1u << slot);
+      }
+      m_bytes.push_back(mask);
+      m_bytes.push_back(leaves);
+      for (uint32_t slot = 0; slot < 8; ++slot) {
+        const int child = nodes[i].children[slot];
+        if (child > 0)
+          write_varint(zigzag(int64_t(offsets[child - 1]) - int64_t(offsets[i])), widths[i * 8 + slot]);
+      }
+      leaf_codes(nodes[i], this);
+    }
+  }
+
+  inline compact_pool_view view() const { return {m_bytes, m_blocks, m_nodes, m_block}; }
+
+  inline operator compact_pool_view() const { return view(); }
+
+  inline size_t size() const { return m_nodes; }
+
+  /// Bytes held, index included.
+  inline size_t memory_usage() const { return m_bytes.size() + m_blocks.size() * sizeof(uint64_t); }
+
+  /// Expands back to the `node_t<int>` form.
+  inline std::vector<node_t<int>> expand() const {
+    std::vector<node_t<int>> nodes(m_nodes);
+    const auto v = view();
+    for (size_t i = 0; i < m_nodes; ++i)
+      nodes[i] = v.node(i);
+    return nodes;
+  }
+
+  inline bool write(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    const uint64_t header[3] = {m_nodes, m_block, m_bytes.size()};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(m_blocks.data()), m_blocks.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(m_bytes.data()), m_bytes.size());
+    return bool(out);
+  }
+
+  /// Reads a file written by `write`; on failure the pool is left empty.
+  inline bool read(const std::string& filename) {
+    m_nodes = 0;
+    m_blocks.clear();
+    m_bytes.clear();
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    const uint64_t file_bytes = uint64_t(in.tellg());
+    in.seekg(0);
+    uint64_t header[3];
+    // Every node takes at least its two mask bytes
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[1] == 0 || header[1] > UINT32_MAX ||
+        header[2] > max_bytes || header[0] > header[2] / 2)
+      return false;
+    const uint64_t blocks = (header[0] + header[1] - 1) / header[1];
+    if (file_bytes != sizeof(header) + blocks * sizeof(uint64_t) + header[2]) return false;
+    m_blocks.resize(blocks);
+    m_bytes.resize(header[2]);
+    if (!in.read(reinterpret_cast<char*>(m_blocks.data()), m_blocks.size() * sizeof(uint64_t)) ||
+        !in.read(reinterpret_cast<char*>(m_bytes.data()), m_bytes.size()))
+      return false;
+    // Block offsets start at the root and increase inside the bytes
+    for (size_t b = 0; b < m_blocks.size(); ++b) {
+      if (m_blocks[b] >= m_bytes.size() || (b == 0 ? m_blocks[b] != 0 : m_blocks[b] <= m_blocks[b - 1])) {
+        m_blocks.clear();
+        m_bytes.clear();
+        return false;
+      }
+    }
+    m_nodes = header[0];
+    m_block = uint32_t(header[1]);
+    return true;
+  }
+
+private:
+  static inline size_t varint_bytes(uint64_t v) { return std::max<size_t>(1, (std::bit_width(v) + 6) / 7); }
+
+  static inline uint64_t zigzag(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+
+  /// Writes `v` in exactly `width` bytes (padded with continuation bytes).
+  inline void write_varint(uint64_t v, size_t width = 0) {
+    width = std::max(width, varint_bytes(v));
+    for (size_t k = 1; k < width; ++k) {
+      m_bytes.push_back(uint8_t(v & 0x7f) | 0x80);
+      v >>= 7;
+    }
+    m_bytes.push_back(uint8_t(v));
+  }
+
+  /// Writes the leaf section of a node into `out` (if given); returns its size in bytes.
+  static inline size_t leaf_codes(const node_t<int>& node, compact_pool* out) {
+    std::vector<uint64_t> codes;
+    for (int child : node.children) {
+      if (child < 0) codes.push_back(uint64_t(-int64_t(child) - 1));
+    }
+    if (codes.empty()) return 0;
+    const bool uniform = std::all_of(codes.begin(), codes.end(), [&](uint64_t c) { return c == codes[0]; });
+    size_t bytes = varint_bytes(codes[0] << 1 | uint64_t(uniform));
+    if (out) out->write_varint(codes[0] << 1 | uint64_t(uniform));
+    if (!uniform) {
+      for (size_t k = 1; k < codes.size(); ++k) {
+        bytes += varint_bytes(codes[k]);
+        if (out) out->write_varint(codes[k]);
+      }
+    }
+    return bytes;
+  }
+
+  std::vector<uint8_t>  m_bytes;
+  std::vector<uint64_t> m_blocks; ///< Byte offset of every `m_block`-th node.
+  size_t                m_nodes = 0;
+  uint32_t              m_block = 16;
+};
+
+/**
+ * @brief `query_point` over the compact encoding.
+ */
+inline int query_point(const compact_pool_view& nodes, const pool_frame_t& frame, glm::vec3 p) {
+  if (nodes.empty()) return 0;
+  const float res = float(1u << frame.depth);
+  const glm::vec3 g = glm::floor((p - frame.corner) / frame.size * res);
+  if (g.x < 0 || g.y < 0 || g.z < 0 || g.x >= res || g.y >= res || g.z >= res)
+    return 0;
+  const glm::uvec3 v(g);
+  int node = 0;
+  for (uint32_t level = frame.depth; level-- > 0;) {
+    const int child = nodes.child(node, child_slot(v.x >> level, v.y >> level, v.z >> level));
+    if (child <= 0) return child;
+    node = child - 1;
+  }
+  return 0;
+}
+
+/**
+ * @brief `query_ray_fixed` over the compact encoding.
+ */
+inline std::optional<float> query_ray(const compact_pool_view& nodes, const pool_frame_t& frame,
+                                      glm::vec3 o, glm::vec3 d, float max_dist) {
+  if (nodes.empty() || frame.depth == 0 || frame.depth > 30) return std::nullopt;
+  const fixed_ray_t ray(frame, o, d);
+  fixed_walk_t walk;
+  int64_t t0, t1;
+  if (!detail::fixed_enter(frame, ray, max_dist, t0, t1, walk.voxel)) return std::nullopt;
+  if (auto t = detail::fixed_walk(nodes, frame.depth, ray, t0, t1, walk))
+    return float((double(*t) / fixed_ray_t::one + ray.t_base) / ray.scale);
+  return std::nullopt;
+}
+
+} // namespace oasis
+
+#endif // NODE_POOL_COMPACT_HPP
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_COW_EDITOR_HPP
+#define NODE_POOL_COW_EDITOR_HPP
+
+#include <oasis/node_pool.hpp>
+#include <bit>
+#include <optional>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @struct edit_stats_t
+ * @brief What a `node_pool_cow_editor` did to the pool.
+ */
+struct edit_stats_t {
+  size_t in_place = 0; ///< Node writes done in place (refcount 1).
+  size_t copies   = 0; ///< Shared nodes path-copied before writing.
+  size_t released = 0; ///< Nodes whose last reference was dropped.
+  size_t reused   = 0; ///< New nodes placed in a freed slot instead of appended.
+};
+
+/**
+ * @class node_pool_cow_editor
+ * @brief Copy-on-write voxel editing driven by per-node reference counts.
+ *
+ * With reference counts tracked, a node referenced by a single parent is
+ * edited in place and only shared nodes on the edit path are copied;
+ * without them every node on the path is copied, as with
+ * `node_pool_editor::duplicate_child`. Nodes whose last reference is
+ * dropped are freed: their slots go to a free bitmap, and new nodes
+ * reuse the free slot closest to their parent before the pool grows.
+ *
+ * The counts and the free bitmap cover changes made through this class.
+ * After modifying or replacing `m_nodes` any other way, call
+ * `track_references()` or `untrack_references()` again: until then the
+ * editor may hand out slots that are live in the new nodes.
+ *
+ * Edits write in place with plain stores and reuse freed slots at once,
+ * so no other thread may traverse the pool during an edit.
+ */
+class node_pool_cow_editor : public virtual node_pool {
+public:
+  /// Default constructor.
+  explicit node_pool_cow_editor() = default;
+
+  /**
+   * @brief Counts the references to every node and starts tracking them.
+   *
+   * The root counts one reference of its own, so it is never released.
+   * Unreachable nodes are freed.
+   */
+  inline void track_references() {
+    reset_allocator();
+    m_tracking = true;
+    m_refcounts.assign(m_nodes.size(), 0);
+    m_free.assign((m_nodes.size() + 63) / 64, 0);
+    if (m_nodes.empty()) return;
+    // Only references held by reachable nodes count
+    m_refcounts[0] = 1;
+    std::vector<int> pending{0};
+    while (!pending.empty()) {
+      const int i = pending.back();
+      pending.pop_back();
+      for (int child : m_nodes[i].children) {
+        if (child > 0 && m_refcounts[child - 1]++ == 0)
+          pending.push_back(child - 1);
+      }
+    }
+    for (size_t i = 1; i < m_refcounts.size(); ++i) {
+      if (m_refcounts[i] == 0) free_slot(int(i));
+    }
+  }
+
+  /// Stops tracking and forgets the free slots; every later edit path-copies and appends.
+  inline void untrack_references() {
+    m_tracking = false;
+    m_refcounts = {};
+    reset_allocator();
+  }
+
+  /**
+   * @brief Forgets every free slot and the state derived classes keep per slot.
+   *
+   * For a pool whose nodes were replaced; called by `track_references`
+   * and `untrack_references`.
+   */
+  inline void reset_allocator() {
+    m_free.clear();
+    m_free_count = 0;
+    m_free_hint = 0;
+    on_reset();
+  }
+
+  inline bool tracks_references() const { return m_tracking; }
+
+  /// References to a node (0 if untracked or free).
+  inline uint32_t refcount(size_t index) const { return index < m_refcounts.size() ? m_refcounts[index] : 0; }
+
+  /**
+   * @brief Sets one voxel of the pool.
+   *
+   * Coarser leaves on the path are split, and nodes emptied by the edit
+   * collapse to an empty child. The root stays at index 0.
+   *
+   * @param voxel Voxel coordinate, each axis in [0, 2^depth).
+   * @param depth Depth the pool was built with.
+   * @param value Leaf value (negative), or 0 to clear the voxel.
+   */
+  inline void set_voxel(glm::uvec3 voxel, uint32_t depth, int value) {
+    if (depth == 0) return;
+    if (m_nodes.empty()) {
+      m_nodes.emplace_back();
+      if (tracked()) m_refcounts.assign(1, 1);
+    }
+    const int root = edit(1, 0, 0, voxel, depth, value);
+    if (root != 1) {
+      // The root was copied (untracked pool): move the copy into slot 0
+      m_nodes[0] = m_nodes[root - 1];
+      for (int child : m_nodes[0].children) {
+        if (child > 0) on_store(child - 1);
+      }
+      if (tracked()) {
+        for (int child : m_nodes[0].children) {
+          if (child > 0) ++m_refcounts[child - 1];
+        }
+        release(root - 1);
+      }
+    }
+  }
+
+  /**
+   * @brief Makes a child node safe to modify in place.
+   *
+   * Copies the child only if it is shared (or references are not tracked).
+   *
+   * @param parent_index Index of the parent node.
+   * @param child_index Child slot (0-7).
+   * @return The index of the now unshared child, or `std::nullopt` if the slot holds no node.
+   */
+  inline std::optional<size_t> unshare_child(size_t parent_index, size_t child_index) {
+    if (parent_index >= m_nodes.size() || child_index >= 8) return std::nullopt;
+    const int child = m_nodes[parent_index].children[child_index];
+    if (child <= 0) return std::nullopt;
+    const int writable = make_writable(child - 1, parent_index);
+    store(parent_index, child_index, writable + 1);
+    return size_t(writable);
+  }
+
+  inline const edit_stats_t& stats() const { return m_stats; }
+
+  inline void reset_stats() { m_stats = {}; }
+
+  /// Free slots waiting for reuse (tracked pools only).
+  inline size_t garbage() const { return m_free_count; }
+
+  /// Whether a slot is free.
+  inline bool is_free(size_t index) const {
+    return index / 64 < m_free.size() && (m_free[index / 64] >> (index % 64)) & 1;
+  }
+
+protected:
+  inline bool tracked() const { return m_tracking; }
+
+  /// Stores a new node in the free slot closest to `near` (its parent), or appends it.
+  inline int allocate(const node_t<int>& node, size_t near) {
+    if (m_free_count > 0) {
+      const size_t slot = find_free(near);
+      m_free[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+      --m_free_count;
+      ++m_stats.reused;
+      m_nodes[slot] = node;
+      if (tracked()) m_refcounts[slot] = 0;
+      on_allocate(int(slot));
+      return int(slot);
+    }
+    m_nodes.push_back(node);
+    if (tracked()) m_refcounts.push_back(0);
+    on_allocate(int(m_nodes.size() - 1));
+    return int(m_nodes.size() - 1);
+  }
+
+  /// Start of `count` consecutive free slots, if there are any.
+  inline std::optional<size_t> find_free_run(size_t count) const {
+    if (count == 0 || m_free_count < count) return std::nullopt;
+    size_t run = 0;
+    for (size_t word = m_free_hint; word < m_free.size(); ++word) {
+      if (m_free[word] == 0) {
+        run = 0;
+        continue;
+      }
+      for (size_t bit = 0; bit < 64; ++bit) {
+        run = (m_free[word] >> bit) & 1 ? run + 1 : 0;
+        if (run == count) return word * 64 + bit + 1 - count;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Stores a node in a chosen slot and hands it the references of node `from`.
+   *
+   * `index` must be a free slot or the current pool size (append). Node
+   * `from` is left in place with no references, for the caller to free.
+   */
+  inline void place(size_t index, const node_t<int>& node, size_t from) {
+    if (index == m_nodes.size()) {
+      m_nodes.push_back(node);
+      if (tracked()) m_refcounts.push_back(0);
+    } else {
+      m_free[index / 64] &= ~(uint64_t(1) << (index % 64));
+      --m_free_count;
+      m_nodes[index] = node;
+    }
+    if (tracked()) {
+      m_refcounts[index] = m_refcounts[from];
+      m_refcounts[from] = 0;
+    }
+    on_allocate(int(index));
+  }
+
+  /// Called when a reference to node `index` is written into the pool.
+  virtual void on_store(int index) { (void)index; }
+
+  /// Called when node `index` is created.
+  virtual void on_allocate(int index) { (void)index; }
+
+  /// Called by `reset_allocator`: per-slot state no longer matches the nodes.
+  virtual void on_reset() {}
+
+  /// Puts an unreferenced slot on the free list.
+  inline void free_slot(int index) {
+    const size_t word = size_t(index) / 64;
+    if (word >= m_free.size()) m_free.resize(word + 1, 0);
+    m_free[word] |= uint64_t(1) << (index % 64);
+    ++m_free_count;
+    m_free_hint = std::min(m_free_hint, word);
+    m_nodes[index] = node_t<int>::null();
+  }
+
+  /// Drops one reference to a node, releasing its children when it was the last.
+  inline void release(int index) {
+    if (!tracked()) return;
+    std::vector<int> pending{index};
+    while (!pending.empty()) {
+      const int i = pending.back();
+      pending.pop_back();
+      if (m_refcounts[i] > 0 && --m_refcounts[i] > 0) continue;
+      ++m_stats.released;
+      for (int child : m_nodes[i].children) {
+        if (child > 0) pending.push_back(child - 1);
+      }
+      free_slot(i);
+    }
+  }
+
+  /// Replaces a child value, keeping reference counts.
+  inline void store(size_t parent, size_t slot, int value) {
+    const int old = m_nodes[parent].children[slot];
+    if (old == value) return;
+    if (tracked() && value > 0) ++m_refcounts[value - 1];
+    if (value > 0) on_store(value - 1);
+    m_nodes[parent].children[slot] = value;
+    if (old > 0) release(old - 1);
+  }
+
+  /// Returns `index` if it may be written in place, otherwise a fresh copy referenced from `parent`.
+  inline int make_writable(int index, size_t parent) {
+    if (tracked() && m_refcounts[index] <= 1) {
+      ++m_stats.in_place;
+      return index;
+    }
+    ++m_stats.copies;
+    const node_t<int> copy = m_nodes[index];
+    const int fresh = allocate(copy, parent);
+    if (tracked()) {
+      for (int child : copy.children) {
+        if (child > 0) ++m_refcounts[child - 1];
+      }
+    }
+    return fresh;
+  }
+
+private:
+  /// Free slot closest to `near`, searching nearby words before the whole bitmap.
+  inline size_t find_free(size_t near) {
+    const size_t words = m_free.size();
+    const size_t center = std::min(near / 64, words - 1);
+    for (size_t dist = 0; dist < 64; ++dist) {
+      if (center + dist < words && m_free[center + dist])
+        return (center + dist) * 64 + std::countr_zero(m_free[center + dist]);
+      if (dist > 0 && dist <= center && m_free[center - dist])
+        return (center - dist) * 64 + std::countr_zero(m_free[center - dist]);
+    }
+    while (!m_free[m_free_hint])
+      ++m_free_hint;
+    return m_free_hint * 64 + std::countr_zero(m_free[m_free_hint]);
+  }
+
+  /// Edits below a child value; returns the child value the parent should hold.
+  inline int edit(int child, size_t parent, uint32_t level, glm::uvec3 voxel, uint32_t depth, int value) {
+    if (level == depth) return value;
+
+    int index;
+    if (child <= 0) {
+      if (child == value) return child;
+      // Split an empty cell or a coarse leaf into eight copies of itself
+      node_t<int> split;
+      split.children.fill(child);
+      index = allocate(split, parent);
+    } else {
+      index = make_writable(child - 1, parent);
+    }
+
+    const uint32_t shift = depth - level - 1;
+    const uint32_t slot = ((voxel.x >> shift) & 1) | (((voxel.y >> shift) & 1) << 1) | (((voxel.z >> shift) & 1) << 2);
+    const int old = m_nodes[index].children[slot];
+    store(size_t(index), slot, edit(old, size_t(index), level + 1, voxel, depth, value));
+
+    // A node left empty collapses (never the root)
+    if (level > 0 && !m_nodes[index].has_value()) {
+      if (tracked() && m_refcounts[index] == 0) {
+        free_slot(index);
+      }
+      return 0;
+    }
+    return index + 1;
+  }
+
+  bool                  m_tracking = false;
+  std::vector<uint32_t> m_refcounts; ///< References per node while tracking.
+  std::vector<uint64_t> m_free;           ///< One bit per free slot.
+  size_t                m_free_count = 0;
+  size_t                m_free_hint  = 0; ///< No free slot below this word.
+  edit_stats_t          m_stats;
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_COW_EDITOR_HPP
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_DEFRAG_HPP
+#define NODE_POOL_DEFRAG_HPP
+
+#include <oasis/node_pool_gc.hpp>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace oasis {
+
+/**
+ * @brief Loads a child value published by `node_pool_defrag`.
+ *
+ * Readers that run while the pool is defragmented use this acquire load,
+ * so the node a child value points at is seen fully written.
+ */
+inline int read_child(std::span<const node_t<int>> nodes, size_t index, uint32_t slot) {
+  return std::atomic_ref<int>(const_cast<int&>(nodes[index].children[slot])).load(std::memory_order_acquire);
+}
+
+/**
+ * @struct defrag_stats_t
+ * @brief Counters of a `node_pool_defrag`.
+ */
+struct defrag_stats_t {
+  size_t subtrees  = 0; ///< Subtrees relocated.
+  size_t moved     = 0; ///< Nodes relocated.
+  size_t retired   = 0; ///< Old slots waiting for readers to move on.
+  size_t reclaimed = 0; ///< Old slots freed.
+  size_t no_room   = 0; ///< Subtrees skipped for lack of a free run or capacity.
+};
+
+/**
+ * @class node_pool_defrag
+ * @brief Online defragmentation while other threads traverse the pool.
+ *
+ * Relocates subtrees into runs of consecutive slots, in depth-first
+ * order, so a traversal through them touches neighbouring memory again.
+ * Only the part of a subtree owned by a single parent (reference count 1)
+ * is moved; shared nodes stay put and are referenced from the copies.
+ *
+ * Readers keep traversing during a relocation:
+ * - The copies are written to free slots first, then published by one
+ *   atomic store to the parent's child (see `read_child`).
+ * - The old slots are retired, not freed: they are freed by `reclaim()`
+ *   once every reader has left the epoch they were retired in.
+ * - The pool never reallocates: nodes are appended only within the
+ *   capacity reserved with `reserve_for_readers`, and the new size is
+ *   published before the copies are (see `reader_nodes`).
+ *
+ * Readers call `reader_enter`/`reader_leave` (or hold a `read_guard`)
+ * around each traversal. Editing, collecting and defragmenting must all
+ * run on one writer thread. Requires `track_references()`.
+ *
+ * The epochs only cover `relocate`, `defragment` and `reclaim`. The
+ * editor (`set_voxel`, `release`) and the collector's sweep free slots
+ * and reuse them at once, and they write the children of singly-owned
+ * nodes in place with plain stores. Run them only while no reader is
+ * inside a traversal (`readers_idle()`).
+ */
+class node_pool_defrag : public node_pool_gc {
+public:
+  /// Most reader threads that may register.
+  static constexpr size_t max_readers = 64;
+
+  /// Default constructor.
+  explicit node_pool_defrag() = default;
+
+  /**
+   * @brief Reserves pool capacity so relocations can append without reallocating.
+   * @param extra Slots to reserve beyond the current size.
+   */
+  inline void reserve_for_readers(size_t extra) {
+    m_nodes.reserve(m_nodes.size() + extra);
+    m_published.store(m_nodes.size(), std::memory_order_release);
+  }
+
+  /**
+   * @brief The nodes a reader may follow.
+   *
+   * Take it inside each `read_guard`: relocations append nodes, and a
+   * child published since the last call may point past the old size.
+   */
+  inline std::span<const node_t<int>> reader_nodes() const {
+    return {m_nodes.data(), m_published.load(std::memory_order_acquire)};
+  }
+
+  /// True if no registered reader is inside a traversal (edits and collection are safe).
+  inline bool readers_idle() const {
+    const size_t readers = std::min(m_reader_count.load(), max_readers);
+    for (size_t i = 0; i < readers; ++i) {
+      if (m_reader_epochs[i].load() != 0) return false;
+    }
+    return true;
+  }
+
+  /// Registers a reader thread; returns its id for `reader_enter`/`reader_leave`.
+  inline size_t register_reader() {
+    const size_t id = m_reader_count.fetch_add(1);
+    if (id >= max_readers) std::abort();
+    return id;
+  }
+
+  /// Starts a traversal: retired slots are kept until the reader leaves.
+  inline void reader_enter(size_t id) {
+    m_reader_epochs[id].store(m_epoch.load());
+    // Pairs with the fence in reclaim(): the writer sees this reader, or the reader sees the new layout
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  /// Ends a traversal.
+  inline void reader_leave(size_t id) {
+    m_reader_epochs[id].store(0, std::memory_order_release);
+  }
+
+  /**
+   * @class read_guard
+   * @brief Scope of one traversal by a registered reader.
+   */
+  class read_guard {
+  public:
+    inline read_guard(node_pool_defrag& pool, size_t id) : m_pool(pool), m_id(id) { m_pool.reader_enter(m_id); }
+    inline ~read_guard() { m_pool.reader_leave(m_id); }
+    read_guard(const read_guard&) = delete;
+    read_guard& operator=(const read_guard&) = delete;
+  private:
+    node_pool_defrag& m_pool;
+    size_t            m_id;
+  };
+
+  /**
+   * @brief Relocates the singly-owned part of the subtree below a child.
+   *
+   * @param parent Index of a reachable node.
+   * @param slot Child slot (0-7) of `parent`.
+   * @return False if nothing was moved (no node, shared, already contiguous, or no room).
+   */
+  inline bool relocate(size_t parent, uint32_t slot) {
+    const int child = m_nodes[parent].children[slot];
+    if (!tracked() || child <= 0 || refcount(child - 1) != 1) return false;
+    std::vector<int> order;
+    collect(child - 1, order, std::numeric_limits<size_t>::max());
+    return move(parent, slot, order);
+  }
+
+  /**
+   * @brief Relocates scattered subtrees, top-down from the root.
+   *
+   * A singly-owned subtree of at most `max_subtree` nodes whose nodes are
+   * not already consecutive in depth-first order is relocated whole;
+   * larger ones are descended into. Retired slots are reclaimed at the end.
+   *
+   * @param max_subtree Largest subtree moved in one piece.
+   * @param max_moves Subtrees to relocate before returning.
+   * @return The number of subtrees relocated.
+   */
+  inline size_t defragment(size_t max_subtree = 4096, size_t max_moves = std::numeric_limits<size_t>::max()) {
+    if (!tracked() || m_nodes.empty()) return 0;
+    size_t moves = 0;
+    std::vector<int> pending{0};
+    std::vector<int> order;
+    while (!pending.empty() && moves < max_moves) {
+      const int parent = pending.back();
+      pending.pop_back();
+      for (uint32_t slot = 0; slot < 8 && moves < max_moves; ++slot) {
+        const int child = m_nodes[parent].children[slot];
+        if (child <= 0) continue;
+        if (refcount(child - 1) != 1) {
+          // Shared: reached from several parents, moved by none of them
+          continue;
+        }
+        order.clear();
+        if (collect(child - 1, order, max_subtree)) {
+          moves += move(size_t(parent), slot, order);
+        } else {
+          pending.push_back(child - 1);
+        }
+      }
+    }
+    reclaim();
+    return moves;
+  }
+
+  /**
+   * @brief Frees retired slots that no reader can still be using.
+   * @return The number of slots freed.
+   */
+  inline size_t reclaim() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    const size_t readers = std::min(m_reader_count.load(), max_readers);
+    for (size_t i = 0; i < readers; ++i) {
+      const uint64_t e = m_reader_epochs[i].load();
+      if (e != 0) oldest = std::min(oldest, e);
+    }
+    size_t freed = 0;
+    size_t kept = 0;
+    for (const auto& [index, epoch] : m_retired) {
+      if (epoch < oldest) {
+        m_pinned[index / 64] &= ~(uint64_t(1) << (index % 64));
+        // The slot may already be free if references were recounted meanwhile
+        if (!is_free(index)) free_slot(index);
+        ++freed;
+      } else {
+        m_retired[kept++] = {index, epoch};
+      }
+    }
+    m_retired.resize(kept);
+    m_stats.reclaimed += freed;
+    m_stats.retired = m_retired.size();
+    return freed;
+  }
+
+  /**
+   * @brief Share of reachable parent-to-child links that stay within `window` slots.
+   *
+   * The closer to 1, the more of a traversal's fetches land near the
+   * node it just read.
+   */
+  inline double layout_locality(size_t window = 16) const {
+    if (m_nodes.empty()) return 1.0;
+    std::vector<uint64_t> seen((m_nodes.size() + 63) / 64, 0);
+    std::vector<int> pending{0};
+    seen[0] = 1;
+    size_t near = 0, links = 0;
+    while (!pending.empty()) {
+      const int i = pending.back();
+      pending.pop_back();
+      for (int child : m_nodes[i].children) {
+        if (child <= 0) continue;
+        ++links;
+        near += size_t(std::abs(child - 1 - i)) <= window;
+        const size_t c = size_t(child - 1);
+        if (!((seen[c / 64] >> (c % 64)) & 1)) {
+          seen[c / 64] |= uint64_t(1) << (c % 64);
+          pending.push_back(child - 1);
+        }
+      }
+    }
+    return links > 0 ? double(near) / double(links) : 1.0;
+  }
+
+  inline const defrag_stats_t& defrag_stats() const { return m_stats; }
+
+protected:
+  /// Retired slots belong to the replaced nodes.
+  inline void on_reset() override {
+    node_pool_gc::on_reset();
+    m_retired.clear();
+    m_pinned.clear();
+    m_stats.retired = 0;
+  }
+
+  /// Retired slots are unreachable but may still be read.
+  inline bool pinned(size_t index) const override {
+    return index / 64 < m_pinned.size() && (m_pinned[index / 64] >> (index % 64)) & 1;
+  }
+
+private:
+  /**
+   * @brief Lists the singly-owned nodes of a subtree in depth-first order.
+   * @return False if there are more than `limit`.
+   */
+  inline bool collect(int root, std::vector<int>& order, size_t limit) const {
+    std::vector<int> pending{root};
+    while (!pending.empty()) {
+      const int i = pending.back();
+      pending.pop_back();
+      if (order.size() == limit) return false;
+      order.push_back(i);
+      for (int slot = 7; slot >= 0; --slot) {
+        const int child = m_nodes[i].children[slot];
+        if (child > 0 && refcount(child - 1) == 1) pending.push_back(child - 1);
+      }
+    }
+    return true;
+  }
+
+  /// Copies `order` to consecutive slots, publishes the copy and retires the old slots.
+  inline bool move(size_t parent, uint32_t slot, const std::vector<int>& order) {
+    const size_t count = order.size();
+    bool contiguous = true;
+    for (size_t k = 1; k < count && contiguous; ++k)
+      contiguous = order[k] == order[0] + int(k);
+    if (contiguous) return false;
+
+    size_t base;
+    if (auto run = find_free_run(count)) {
+      base = *run;
+    } else if (m_nodes.size() + count <= m_nodes.capacity()) {
+      base = m_nodes.size();
+    } else {
+      ++m_stats.no_room;
+      return false;
+    }
+
+    // Old index -> new index, for the nodes being moved
+    std::unordered_map<int, int> remap;
+    remap.reserve(count);
+    for (size_t k = 0; k < count; ++k)
+      remap.emplace(order[k], int(base + k));
+
+    for (size_t k = 0; k < count; ++k) {
+      node_t<int> node = m_nodes[order[k]];
+      for (auto& child : node.children) {
+        if (child <= 0) continue;
+        auto it = remap.find(child - 1);
+        if (it != remap.end()) child = it->second + 1;
+      }
+      place(base + k, node, size_t(order[k]));
+    }
+    m_published.store(m_nodes.size(), std::memory_order_release);
+
+    // Publish: readers either still see the old subtree or all of the new one
+    std::atomic_ref<int>(m_nodes[parent].children[slot]).store(int(base) + 1, std::memory_order_release);
+    on_store(int(base));
+
+    const uint64_t epoch = m_epoch.fetch_add(1);
+    if (m_pinned.size() < (m_nodes.size() + 63) / 64) m_pinned.resize((m_nodes.size() + 63) / 64, 0);
+    for (int old : order) {
+      m_pinned[size_t(old) / 64] |= uint64_t(1) << (old % 64);
+      m_retired.emplace_back(size_t(old), epoch);
+    }
+
+    ++m_stats.subtrees;
+    m_stats.moved += count;
+    m_stats.retired = m_retired.size();
+    return true;
+  }
+
+  std::atomic<uint64_t>                            m_epoch{1};
+  std::array<std::atomic<uint64_t>, max_readers>   m_reader_epochs{}; ///< Epoch each reader entered in, 0 when outside.
+  std::atomic<size_t>                              m_reader_count{0};
+  std::atomic<size_t>                              m_published{0}; ///< Size readers may index up to.
+  std::vector<std::pair<size_t, uint64_t>>         m_retired; ///< Old slot and the epoch it was retired in.
+  std::vector<uint64_t>                            m_pinned;  ///< One bit per retired slot.
+  defrag_stats_t                                   m_stats;
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_DEFRAG_HPP
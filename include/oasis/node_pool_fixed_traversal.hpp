@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_FIXED_TRAVERSAL_HPP
+#define NODE_POOL_FIXED_TRAVERSAL_HPP
+
+#include <oasis/node_pool_queries.hpp>
+#include <oasis/voxel_attributes.hpp>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @brief Child slot of voxel `v` below a node whose children are `1 << shift` voxels wide.
+ *
+ * Exported by liboasis. It weights the extracted bits through a float dot
+ * product out of line, so the kernels below use `child_slot_bfe`.
+ */
+size_t extract_child_slot_bfe(const glm::uvec3& v, uint32_t shift);
+
+/**
+ * @brief Inline `extract_child_slot_bfe`.
+ *
+ * A bit-field extract per axis; compiles to shifts and masks (or BEXTR).
+ */
+constexpr uint32_t child_slot_bfe(glm::uvec3 v, uint32_t shift) {
+  return ((v.x >> shift) & 1u) | (((v.y >> shift) & 1u) << 1) | (((v.z >> shift) & 1u) << 2);
+}
+
+/**
+ * @struct fixed_ray_t
+ * @brief A ray in a pool's voxel grid, in fixed point.
+ *
+ * Positions are in voxels with `frac_bits` fractional bits; the ray
+ * parameter runs in voxels along a unit-length grid direction with the
+ * same scaling, so coordinates keep 2^-30 voxel resolution at any depth
+ * up to 30, where float positions run out of mantissa past depth 24.
+ */
+struct fixed_ray_t {
+  static constexpr int     frac_bits = 30;
+  static constexpr int64_t one       = int64_t(1) << frac_bits;
+  static constexpr int64_t infinity  = std::numeric_limits<int64_t>::max();
+
+  int64_t o[3];   ///< Origin, fixed point voxels.
+  int64_t d[3];   ///< Unit direction, fixed point.
+  int64_t inv[3]; ///< 1 / d, fixed point (0 for axes the ray is parallel to).
+  double  scale;  ///< Grid distance per world distance (0 if the ray misses the grid).
+  double  t_base; ///< Grid distance the origin was advanced by to reach the grid.
+
+  /// Converts a world-space ray into the grid of `frame`.
+  inline fixed_ray_t(const pool_frame_t& frame, glm::vec3 wo, glm::vec3 wd) {
+    const double grid = double(uint64_t(1) << frame.depth);
+    const double k = grid / frame.size;
+    double go[3], u[3], len = 0;
+    for (int a = 0; a < 3; ++a) {
+      go[a] = (double(wo[a]) - frame.corner[a]) * k;
+      u[a] = double(wd[a]) * k;
+      len += u[a] * u[a];
+    }
+    len = std::sqrt(len);
+    scale = len > 0 ? len / std::sqrt(double(wd.x) * wd.x + double(wd.y) * wd.y + double(wd.z) * wd.z) : 0;
+
+    // Start next to the grid so far-away origins keep full precision
+    double t_near = 0, t_far = std::numeric_limits<double>::max();
+    for (int a = 0; a < 3; ++a) {
+      u[a] = len > 0 ? u[a] / len : 0;
+      if (std::abs(u[a]) > 1e-9) {
+        const double ta = -go[a] / u[a], tb = (grid - go[a]) / u[a];
+        t_near = std::max(t_near, std::min(ta, tb));
+        t_far = std::min(t_far, std::max(ta, tb));
+      } else if (go[a] < 0 || go[a] >= grid) {
+        t_far = -1;
+      }
+    }
+    if (t_near > t_far)
+      scale = 0; // misses the grid
+    t_base = std::max(0.0, t_near - 1.0);
+    for (int a = 0; a < 3; ++a) {
+      o[a] = int64_t(std::clamp(go[a] + u[a] * t_base, -2.0 * grid, 2.0 * grid) * one);
+      d[a] = int64_t(std::llround(u[a] * one));
+      inv[a] = std::abs(u[a]) > 1e-9 ? int64_t(std::llround(one / u[a])) : 0;
+    }
+  }
+
+  /// Ray parameter where the ray crosses coordinate `b` (fixed point) on axis `a`.
+  inline int64_t t_at(int a, int64_t b) const {
+    if (inv[a] == 0) return infinity;
+    const __int128 t = (__int128(b - o[a]) * inv[a]) >> frac_bits;
+    if (t > __int128(infinity)) return infinity;
+    if (t < -__int128(infinity)) return -infinity;
+    return int64_t(t);
+  }
+
+  /// Voxel coordinate of the ray at `t` on axis `a`, floored.
+  inline int64_t voxel_at(int a, int64_t t) const {
+    return int64_t((__int128(o[a]) + ((__int128(d[a]) * t) >> frac_bits)) >> frac_bits);
+  }
+};
+
+/**
+ * @struct fixed_walk_t
+ * @brief State of a fixed-point traversal: the current voxel and the node path to it.
+ *
+ * `stack[l]` is the node at level `l` whose cell contains `voxel`, for
+ * every `l <= level`.
+ */
+struct fixed_walk_t {
+  int        stack[32] = {0};
+  uint32_t   level     = 0;
+  glm::uvec3 voxel     = glm::uvec3(0);
+  size_t     fetches   = 0;       ///< Nodes read so far.
+  uint32_t*  counts    = nullptr; ///< Per-node read counters to bump, when profiling (node arrays only).
+};
+
+namespace detail {
+
+/// Clips a ray to the grid; returns the entry voxel and the parameter range.
+inline bool fixed_enter(const pool_frame_t& frame, const fixed_ray_t& ray, float max_dist,
+                        int64_t& t0, int64_t& t1, glm::uvec3& v) {
+  if (ray.scale <= 0) return false;
+  const int64_t grid = int64_t(1) << frame.depth;
+  const int64_t t_max = int64_t(std::clamp((double(max_dist) * ray.scale - ray.t_base) * fixed_ray_t::one, 
+                                            -1.0, double(fixed_ray_t::infinity) / 2));
+  if (t_max < 0) return false;
+
+  t0 = 0;
+  t1 = t_max;
+  for (int a = 0; a < 3; ++a) {
+    if (ray.inv[a] == 0) {
+      if (ray.o[a] < 0 || ray.o[a] >= grid * fixed_ray_t::one) return false;
+      continue;
+    }
+    int64_t ta = ray.t_at(a, 0), tb = ray.t_at(a, grid * fixed_ray_t::one);
+    if (ta > tb) std::swap(ta, tb);
+    t0 = std::max(t0, ta);
+    t1 = std::min(t1, tb);
+  }
+  if (t0 > t1) return false;
+
+  for (int a = 0; a < 3; ++a)
+    v[a] = uint32_t(std::clamp<int64_t>(ray.voxel_at(a, t0), 0, grid - 1));
+  return true;
+}
+
+/// Child `slot` of node `index`, for node arrays and for encodings with a `child(index, slot)` accessor.
+template <typename Nodes>
+inline int child_at(const Nodes& nodes, size_t index, uint32_t slot) {
+  if constexpr (requires { nodes.child(index, slot); })
+    return nodes.child(index, slot);
+  else
+    return nodes[index].children[slot];
+}
+
+/**
+ * @brief Walks the ray from `walk.voxel` at parameter `t`, starting at `walk.stack[walk.level]`.
+ * @tparam Nodes A node span, or any encoding with a `child(index, slot)` accessor.
+ * @return The hit parameter, or `std::nullopt` if the ray leaves the grid or passes `t1`.
+ */
+template <typename Nodes = std::span<const node_t<int>>>
+inline std::optional<int64_t> fixed_walk(const Nodes& nodes, uint32_t depth, const fixed_ray_t& ray,
+                                         int64_t t, int64_t t1, fixed_walk_t& walk) {
+  const int64_t grid = int64_t(1) << depth;
+  glm::uvec3& v = walk.voxel;
+  uint32_t& level = walk.level;
+
+  for (;;) {
+    // Descend until a leaf or an empty cell
+    const uint32_t shift = depth - level - 1;
+    ++walk.fetches;
+    // Encodings keep byte offsets on the stack, not node indices: no profiling there
+    if constexpr (!requires { nodes.child(size_t(0), 0u); })
+      if (walk.counts) ++walk.counts[walk.stack[level]];
+    const int child = child_at(nodes, walk.stack[level], child_slot_bfe(v, shift));
+    if (child < 0)
+      return t;
+    if (child > 0 && level + 1 < depth) {
+      walk.stack[++level] = child - 1;
+      continue;
+    }
+
+    // Step out of the empty child cell (1 << shift voxels wide)
+    int exit_axis = -1;
+    int64_t t_exit = fixed_ray_t::infinity;
+    for (int a = 0; a < 3; ++a) {
+      if (ray.inv[a] == 0) continue;
+      const int64_t lo = int64_t(v[a] >> shift) << shift;
+      const int64_t b = ray.d[a] > 0 ? lo + (int64_t(1) << shift) : lo;
+      const int64_t ta = ray.t_at(a, b * fixed_ray_t::one);
+      if (ta < t_exit) {
+        t_exit = ta;
+        exit_axis = a;
+      }
+    }
+    if (exit_axis < 0 || t_exit > t1) return std::nullopt;
+    t = std::max(t, t_exit);
+
+    glm::uvec3 next;
+    for (int a = 0; a < 3; ++a) {
+      const int64_t lo = int64_t(v[a] >> shift) << shift;
+      if (a == exit_axis) {
+        const int64_t n = ray.d[a] > 0 ? lo + (int64_t(1) << shift) : lo - 1;
+        if (n < 0 || n >= grid) return std::nullopt;
+        next[a] = uint32_t(n);
+      } else {
+        // Stay in the same cell on the other axes; only the finer bits follow the ray
+        next[a] = uint32_t(std::clamp<int64_t>(ray.voxel_at(a, t), lo, lo + (int64_t(1) << shift) - 1));
+      }
+    }
+
+    const uint32_t diff = (v.x ^ next.x) | (v.y ^ next.y) | (v.z ^ next.z);
+    level = depth - uint32_t(std::bit_width(diff));
+    v = next;
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Casts a ray using integer voxel coordinates and fixed-point distances.
+ *
+ * Same contract as `query_ray` (world distances whatever the length of
+ * `d`). Instead of a stack of float cells, the
+ * current voxel `v` is kept as integers: descending reads child slots
+ * from the bits of `v`, and after stepping into the next cell the level
+ * to resume from is the highest bit in which the old and new `v` differ,
+ * so only one node index per level is stored.
+ *
+ * With `attributes` and `rank` set, a hit also stores the leaf's rank in
+ * the attribute stream, summed over the node path the walk already holds.
+ */
+inline std::optional<float> query_ray_fixed(std::span<const node_t<int>> nodes, const pool_frame_t& frame,
+                                            glm::vec3 o, glm::vec3 d, float max_dist,
+                                            const voxel_attributes* attributes = nullptr, uint64_t* rank = nullptr) {
+  if (nodes.empty() || frame.depth == 0 || frame.depth > 30) return std::nullopt;
+  const fixed_ray_t ray(frame, o, d);
+  fixed_walk_t walk;
+  int64_t t0, t1;
+  if (!detail::fixed_enter(frame, ray, max_dist, t0, t1, walk.voxel)) return std::nullopt;
+  if (auto t = detail::fixed_walk(nodes, frame.depth, ray, t0, t1, walk)) {
+    if (attributes && rank) *rank = attributes->rank(walk.stack, walk.level, walk.voxel, frame.depth);
+    return float((double(*t) / fixed_ray_t::one + ray.t_base) / ray.scale);
+  }
+  return std::nullopt;
+}
+
+/**
+ * @class traversal_context
+ * @brief Casts a sequence of coherent rays, reusing the previous ray's node path.
+ *
+ * The context remembers the voxel where the last ray stopped and the
+ * nodes above it. A new ray starts from the deepest of those nodes whose
+ * cell also contains the new ray's entry voxel, instead of from the
+ * root. Results are identical to `query_ray_fixed`; only the number of
+ * node fetches changes. One context per thread.
+ */
+class traversal_context {
+public:
+  inline explicit traversal_context(std::span<const node_t<int>> nodes, const pool_frame_t& frame)
+    : m_nodes(nodes), m_frame(frame) {}
+
+  /// Same contract as `query_ray_fixed`.
+  inline std::optional<float> trace(glm::vec3 o, glm::vec3 d, float max_dist) {
+    if (m_nodes.empty() || m_frame.depth == 0 || m_frame.depth > 30) return std::nullopt;
+    const fixed_ray_t ray(m_frame, o, d);
+    int64_t t0, t1;
+    glm::uvec3 v;
+    if (!detail::fixed_enter(m_frame, ray, max_dist, t0, t1, v)) return std::nullopt;
+
+    // Deepest remembered node whose cell contains the entry voxel
+    const uint32_t diff = (v.x ^ m_walk.voxel.x) | (v.y ^ m_walk.voxel.y) | (v.z ^ m_walk.voxel.z);
+    m_walk.level = std::min(m_walk.level, m_frame.depth - uint32_t(std::bit_width(diff)));
+    m_walk.voxel = v;
+    m_restart_levels += m_walk.level;
+    m_walk.counts = m_counts && m_rays % m_sample_every == 0 ? m_counts : nullptr;
+    ++m_rays;
+
+    if (auto t = detail::fixed_walk(m_nodes, m_frame.depth, ray, t0, t1, m_walk))
+      return float((double(*t) / fixed_ray_t::one + ray.t_base) / ray.scale);
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Counts the nodes read by every `sample_every`-th ray.
+   * @param counts One counter per node (owned by the caller, e.g. an `access_counter`), or null to stop.
+   */
+  inline void profile(uint32_t* counts, uint32_t sample_every = 1) {
+    m_counts = counts;
+    m_sample_every = std::max(1u, sample_every);
+  }
+
+  /// Forgets the remembered path (the next ray starts at the root).
+  inline void reset() { m_walk = fixed_walk_t{}; m_rays = 0; m_restart_levels = 0; }
+
+  /// Nodes read by all rays since the last reset.
+  inline size_t fetches() const { return m_walk.fetches; }
+
+  /// Path of the last ray; after a hit, the leaf is a child of `stack[level]`.
+  inline const fixed_walk_t& walk() const { return m_walk; }
+
+  /// Rank of the last hit's leaf in `attributes` (built for this pool).
+  inline uint64_t rank(const voxel_attributes& attributes) const {
+    return attributes.rank(m_walk.stack, m_walk.level, m_walk.voxel, m_frame.depth);
+  }
+
+  /// Average level the rays started from (0 = root).
+  inline double average_restart_level() const { return m_rays ? double(m_restart_levels) / m_rays : 0.0; }
+
+private:
+  std::span<const node_t<int>> m_nodes;
+  pool_frame_t                 m_frame;
+  fixed_walk_t                 m_walk;
+  size_t                       m_rays = 0;
+  size_t                       m_restart_levels = 0;
+  uint32_t*                    m_counts = nullptr;
+  uint32_t                     m_sample_every = 1;
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_FIXED_TRAVERSAL_HPP
@@ -1 +1,208 @@
-// Not yet implemented
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_GC_HPP
+#define NODE_POOL_GC_HPP
+
+#include <oasis/node_pool_cow_editor.hpp>
+#include <chrono>
+#include <vector>
+
+namespace oasis {
+
+/**
+ * @enum gc_phase_t
+ * @brief Where a `node_pool_gc` cycle is.
+ */
+enum class gc_phase_t {
+  idle,  ///< No cycle running.
+  mark,  ///< Tracing from the root.
+  sweep  ///< Freeing unmarked slots.
+};
+
+/**
+ * @struct gc_stats_t
+ * @brief Counters of a `node_pool_gc`.
+ */
+struct gc_stats_t {
+  size_t cycles       = 0; ///< Completed cycles.
+  size_t slices       = 0; ///< Calls to `gc_step` that did work.
+  size_t marked       = 0; ///< Nodes marked in the last cycle.
+  size_t freed        = 0; ///< Slots freed by sweeps (all cycles).
+  double max_slice_us = 0; ///< Longest slice.
+  double total_us     = 0; ///< Time spent in all slices.
+};
+
+/**
+ * @class node_pool_gc
+ * @brief Incremental mark-sweep collector for an edited pool.
+ *
+ * A cycle marks every node reachable from the root, then sweeps the
+ * unmarked slots onto the editor's free list. `gc_step` does a bounded
+ * slice of that work, so a cycle over a large pool can be spread across
+ * frames while editing continues:
+ * - A write barrier marks (shades) any node whose reference is stored
+ *   during the mark phase, so edits between slices cannot hide a live node.
+ * - Nodes created during a cycle are allocated marked.
+ * Garbage created during a cycle is collected by the next one.
+ *
+ * Nodes are not moved; indices stay valid across cycles. Swept slots
+ * are reused at once, so no other thread may traverse during a slice.
+ */
+class node_pool_gc : public node_pool_cow_editor {
+public:
+  /// Default constructor.
+  explicit node_pool_gc() = default;
+
+  /// Starts a cycle if none is running.
+  inline void gc_start() {
+    if (m_phase != gc_phase_t::idle) return;
+    m_marks.assign((m_nodes.size() + 63) / 64, 0);
+    m_gray.clear();
+    m_marked = 0;
+    m_sweep = 0;
+    m_phase = gc_phase_t::mark;
+    if (!m_nodes.empty()) shade(0);
+  }
+
+  /**
+   * @brief Does up to `budget_us` microseconds of collection work.
+   *
+   * Starts a cycle if none is running.
+   *
+   * @return True when this call finished the cycle.
+   */
+  inline bool gc_step(double budget_us) {
+    gc_start();
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed_us = [&]() {
+      return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    bool done = false;
+    for (size_t work = 0; !done; ++work) {
+      if ((work & 63) == 0 && work > 0 && elapsed_us() >= budget_us) break;
+
+      if (m_phase == gc_phase_t::mark) {
+        if (m_gray.empty()) {
+          m_phase = gc_phase_t::sweep;
+          continue;
+        }
+        const int i = m_gray.back();
+        m_gray.pop_back();
+        for (int child : m_nodes[i].children) {
+          if (child > 0) shade(child - 1);
+        }
+      } else {
+        // Sweep one bitmap word (64 slots) per unit of work
+        const size_t end = std::min(m_sweep + 64, m_nodes.size());
+        for (; m_sweep < end; ++m_sweep) {
+          if (!marked(m_sweep) && !is_free(m_sweep) && !pinned(m_sweep)) {
+            free_slot(int(m_sweep));
+            ++m_stats.freed;
+          }
+        }
+        if (m_sweep >= m_nodes.size()) {
+          m_phase = gc_phase_t::idle;
+          m_stats.marked = m_marked;
+          ++m_stats.cycles;
+          done = true;
+        }
+      }
+    }
+
+    const double us = elapsed_us();
+    ++m_stats.slices;
+    m_stats.total_us += us;
+    m_stats.max_slice_us = std::max(m_stats.max_slice_us, us);
+    return done;
+  }
+
+  /// Runs a whole cycle (finishing the current one if running).
+  inline void gc_collect() {
+    while (!gc_step(1e30)) {}
+  }
+
+  inline gc_phase_t gc_phase() const { return m_phase; }
+
+  inline const gc_stats_t& gc_stats() const { return m_stats; }
+
+  inline void reset_gc_stats() { m_stats = {}; }
+
+protected:
+  /// Write barrier: a reference stored during marking keeps its target alive.
+  inline void on_store(int index) override {
+    if (m_phase == gc_phase_t::mark) shade(index);
+  }
+
+  /// Nodes created during a cycle are allocated marked.
+  inline void on_allocate(int index) override {
+    if (m_phase == gc_phase_t::idle) return;
+    set_mark(size_t(index));
+    // Children were referenced by the copied node and are shaded through it
+    if (m_phase == gc_phase_t::mark) m_gray.push_back(index);
+  }
+
+  /// Drops a running cycle and its marks.
+  inline void on_reset() override {
+    m_phase = gc_phase_t::idle;
+    m_marks.clear();
+    m_gray.clear();
+    m_sweep = 0;
+    m_marked = 0;
+  }
+
+  /// Unreachable slots the sweep must leave alone (e.g. still read by other threads).
+  virtual bool pinned(size_t index) const { (void)index; return false; }
+
+private:
+  inline bool marked(size_t index) const {
+    return index / 64 < m_marks.size() && (m_marks[index / 64] >> (index % 64)) & 1;
+  }
+
+  inline bool set_mark(size_t index) {
+    if (index / 64 >= m_marks.size()) m_marks.resize(index / 64 + 1, 0);
+    const uint64_t bit = uint64_t(1) << (index % 64);
+    if (m_marks[index / 64] & bit) return false;
+    m_marks[index / 64] |= bit;
+    ++m_marked;
+    return true;
+  }
+
+  inline void shade(int index) {
+    if (set_mark(size_t(index))) m_gray.push_back(index);
+  }
+
+  gc_phase_t            m_phase  = gc_phase_t::idle;
+  std::vector<uint64_t> m_marks;      ///< One bit per marked slot.
+  std::vector<int>      m_gray;       ///< Marked nodes whose children are not yet scanned.
+  size_t                m_sweep  = 0; ///< Next slot to sweep.
+  size_t                m_marked = 0;
+  gc_stats_t            m_stats;
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_GC_HPP
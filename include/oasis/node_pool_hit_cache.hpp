@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_HIT_CACHE_HPP
+#define NODE_POOL_HIT_CACHE_HPP
+
+#include <oasis/node_pool_fixed_traversal.hpp>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @struct hit_cache_stats_t
+ * @brief Counters of a `hit_cache`.
+ */
+struct hit_cache_stats_t {
+  size_t queries       = 0; ///< Rays traced through the cache.
+  size_t hits          = 0; ///< Answered from a cached leaf cell (reused or validated).
+  size_t fetches       = 0; ///< Nodes read (validation and fallback traversal).
+  size_t saved_fetches = 0; ///< Estimated nodes not read thanks to cache hits.
+
+  inline double hit_rate() const { return queries ? double(hits) / queries : 0.0; }
+};
+
+/**
+ * @class hit_cache
+ * @brief Reuses last frame's hit for rays that barely moved.
+ *
+ * Rays are keyed by the caller (sensor ray index, bundle id, ...). For a
+ * key seen before whose cached leaf is still solid (one node read through
+ * the cached parent):
+ * - a ray that did not move gets the cached distance back;
+ * - a ray that moved less than the tolerances and still enters the cached
+ *   cell is walked only up to that cell, from the context's remembered
+ *   path. A hit there or anything in front of it is the nearest hit.
+ * Otherwise the ray is traced in full and the cache entry refreshed.
+ *
+ * Answers equal `query_ray_fixed` as long as the pool does not change;
+ * call `clear` after editing it.
+ */
+class hit_cache {
+public:
+  /**
+   * @param max_shift Largest origin movement (world units) a cached cell is validated for.
+   * @param max_angle Largest direction change (radians) a cached cell is validated for.
+   */
+  inline explicit hit_cache(std::span<const node_t<int>> nodes, const pool_frame_t& frame,
+                            float max_shift, float max_angle = 0.01f)
+    : m_context(nodes, frame), m_nodes(nodes), m_frame(frame), 
+      m_max_shift(max_shift), m_min_cos(std::cos(max_angle)) {}
+
+  /// Same contract as `query_ray_fixed`, with the ray's cache key.
+  inline std::optional<float> trace(uint64_t key, glm::vec3 o, glm::vec3 d, float max_dist) {
+    ++m_stats.queries;
+    auto it = m_entries.find(key);
+    if (it != m_entries.end() && solid(it->second)) {
+      entry_t& e = it->second;
+      if (o == e.o && d == e.d) {
+        // Same ray over the same pool: nothing can have come in front of the cell
+        if (e.t <= max_dist) {
+          ++m_stats.hits;
+          ++m_stats.fetches;
+          m_stats.saved_fetches += saved(1);
+          return e.t;
+        }
+      } else if (glm::length(o - e.o) <= m_max_shift && glm::dot(d, e.d) >= m_min_cos * glm::length(d) * glm::length(e.d)) {
+        if (auto t0 = cell_entry(e, o, d); t0 && *t0 <= max_dist) {
+          // Walk the segment in front of the cached cell and the cell itself
+          const float voxel = m_frame.size / float(1u << m_frame.depth);
+          const float bound = std::min(max_dist, *t0 + 1.75f * voxel * float(1u << e.shift));
+          const size_t before = m_context.fetches();
+          const auto t = m_context.trace(o, d, bound);
+          const size_t fetched = 1 + m_context.fetches() - before;
+          m_stats.fetches += fetched;
+          if (t || bound >= max_dist) {
+            ++m_stats.hits;
+            m_stats.saved_fetches += saved(fetched);
+            if (t)
+              remember(e, o, d, *t);
+            else
+              m_entries.erase(it);
+            return t;
+          }
+        }
+      }
+    }
+
+    const size_t before = m_context.fetches();
+    const auto t = m_context.trace(o, d, max_dist);
+    const size_t fetched = m_context.fetches() - before;
+    m_stats.fetches += fetched;
+    m_full_fetches += fetched;
+    ++m_full_traces;
+
+    if (t)
+      remember(m_entries[key], o, d, *t);
+    else if (it != m_entries.end())
+      m_entries.erase(it);
+    return t;
+  }
+
+  /// Drops every cached entry (e.g. after the pool changed).
+  inline void clear() { m_entries.clear(); }
+
+  inline const hit_cache_stats_t& stats() const { return m_stats; }
+
+  inline void reset_stats() { m_stats = {}; }
+
+  /// Average nodes read by a full traversal.
+  inline double average_fetches() const { return m_full_traces ? double(m_full_fetches) / m_full_traces : 0.0; }
+
+private:
+  struct entry_t {
+    glm::vec3  o, d;     ///< Ray the entry was last validated for.
+    float      t;        ///< Its hit distance.
+    int        parent;   ///< Node holding the leaf.
+    uint32_t   shift;    ///< Leaf cell is 1 << shift voxels wide.
+    glm::uvec3 cell;     ///< Leaf cell coordinate at its level.
+  };
+
+  /// Records the leaf the context's last trace stopped in.
+  inline void remember(entry_t& e, glm::vec3 o, glm::vec3 d, float t) const {
+    const fixed_walk_t& walk = m_context.walk();
+    e.o = o;
+    e.d = d;
+    e.t = t;
+    e.parent = walk.stack[walk.level];
+    e.shift = m_frame.depth - walk.level - 1;
+    e.cell = walk.voxel >> e.shift;
+  }
+
+  inline bool solid(const entry_t& e) const {
+    return m_nodes[e.parent].children[child_slot_bfe(e.cell, 0)] < 0;
+  }
+
+  /// Fetches a cache hit saved over an average full traversal.
+  inline size_t saved(size_t fetched) const {
+    const size_t average = size_t(average_fetches());
+    return average > fetched ? average - fetched : 0;
+  }
+
+  /// World distance at which the ray enters the cached cell, if it does (the units `trace` takes, whatever `|d|`).
+  inline std::optional<float> cell_entry(const entry_t& e, glm::vec3 o, glm::vec3 d) const {
+    const float voxel = m_frame.size / float(1u << m_frame.depth);
+    const float size = voxel * float(1u << e.shift);
+    const glm::vec3 lo = m_frame.corner + glm::vec3(e.cell) * size;
+    float t0 = 0.0f, t1 = std::numeric_limits<float>::infinity();
+    for (int a = 0; a < 3; ++a) {
+      if (d[a] == 0.0f) {
+        // Parallel to the slab: inside it or never
+        if (o[a] < lo[a] || o[a] >= lo[a] + size) return std::nullopt;
+        continue;
+      }
+      const float ta = (lo[a] - o[a]) / d[a], tb = (lo[a] + size - o[a]) / d[a];
+      t0 = std::max(t0, std::min(ta, tb));
+      t1 = std::min(t1, std::max(ta, tb));
+    }
+    if (t0 > t1) return std::nullopt;
+    return t0 * glm::length(d);
+  }
+
+  traversal_context                     m_context;
+  std::span<const node_t<int>>          m_nodes;
+  pool_frame_t                          m_frame;
+  float                                 m_max_shift;
+  float                                 m_min_cos;
+  std::unordered_map<uint64_t, entry_t> m_entries;
+  hit_cache_stats_t                     m_stats;
+  size_t                                m_full_fetches = 0;
+  size_t                                m_full_traces  = 0;
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_HIT_CACHE_HPP
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_IMPLICIT_TOP_HPP
+#define NODE_POOL_IMPLICIT_TOP_HPP
+
+#include <oasis/node_pool_fixed_traversal.hpp>
+#include <oasis/node_pool_queries.hpp>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace oasis {
+
+/**
+ * @class implicit_top_levels
+ * @brief Pointerless complete-octree layout of a pool's top levels.
+ *
+ * The first `levels` levels are stored as an implicit octree in heap
+ * order: cell `g` has its children at `8g + 1 .. 8g + 8`, so a child is
+ * found by arithmetic instead of a dependent node load. Each implicit
+ * cell holds one occupancy byte; the cells of level `levels` hold the
+ * child values of the pool there (subtree root index + 1, a leaf, or 0),
+ * in Morton order. Coarse leaves above that level are split down to it.
+ *
+ * A point lookup indexes level `levels` directly, saving `levels`
+ * dependent loads. Rays run the fixed-point kernel with the implicit
+ * cells as virtual nodes past the end of the node array (see `child`):
+ * a ray starts at its entry cell of the bottom implicit level (`seed`),
+ * and steps that climb back into the implicit levels read a small table
+ * at computed addresses.
+ */
+class implicit_top_levels {
+public:
+  inline implicit_top_levels() = default;
+
+  /**
+   * @param nodes The pool (root at index 0); must outlive this object.
+   * @param depth Depth the pool was built with.
+   * @param levels Implicit levels (clamped to `depth - 1`); 8^levels cells are kept at the bottom one.
+   */
+  inline implicit_top_levels(std::span<const node_t<int>> nodes, uint32_t depth, uint32_t levels)
+    : m_nodes(nodes), m_depth(depth), m_levels(std::min(levels, depth > 0 ? depth - 1 : 0)) {
+    if (m_levels == 0 || nodes.empty()) {
+      m_levels = 0;
+      return;
+    }
+    // Cells above the bottom implicit level, and the values one level below them
+    m_last = ((uint64_t(1) << (3 * (m_levels - 1))) - 1) / 7;
+    m_masks.assign(((uint64_t(1) << (3 * m_levels)) - 1) / 7, 0);
+    m_roots.assign(size_t(1) << (3 * m_levels), 0);
+
+    // Value covering each cell of the current level, level by level
+    std::vector<int> values{1};
+    for (uint32_t level = 0; level < m_levels; ++level) {
+      std::vector<int> next(values.size() * 8, 0);
+      const uint64_t first = ((uint64_t(1) << (3 * level)) - 1) / 7;
+      for (size_t c = 0; c < values.size(); ++c) {
+        const int value = values[c];
+        uint8_t mask = 0;
+        for (uint32_t slot = 0; slot < 8; ++slot) {
+          const int child = value > 0 ? nodes[value - 1].children[slot] : value;
+          next[c * 8 + slot] = child;
+          if (child != 0) mask |= uint8_t(1u << slot);
+        }
+        m_masks[first + c] = mask;
+      }
+      values = std::move(next);
+    }
+    m_roots = std::move(values);
+  }
+
+  inline uint32_t levels() const { return m_levels; }
+
+  inline bool empty() const { return m_nodes.empty(); }
+
+  /// Index the fixed-point kernel starts from: the implicit root cell (or node 0 without implicit levels).
+  inline size_t root() const { return m_levels ? m_nodes.size() : 0; }
+
+  /**
+   * @brief Child `slot` of a real node or of an implicit cell.
+   *
+   * Implicit cell `g` is addressed as index `nodes.size() + g`.
+   */
+  inline int child(size_t index, uint32_t slot) const {
+    if (index < m_nodes.size()) return m_nodes[index].children[slot];
+    const uint64_t g = index - m_nodes.size();
+    if (!(m_masks[g] >> slot & 1)) return 0;
+    if (g >= m_last) return m_roots[(g - m_last) * 8 + slot];
+    return int(m_nodes.size() + 8 * g + 1 + slot) + 1;
+  }
+
+  /**
+   * @brief Points a walk at the bottom implicit cell containing `walk.voxel`.
+   *
+   * The cells above it are filled in by arithmetic, so the walk skips the
+   * descent through the implicit levels. An empty cell on the way acts as
+   * an empty node and the walk steps out of it.
+   */
+  inline void seed(fixed_walk_t& walk) const {
+    walk.stack[0] = int(root());
+    walk.level = 0;
+    if (m_levels == 0) return;
+    uint64_t cell = 0;
+    for (uint32_t l = 1; l < m_levels; ++l) {
+      const uint32_t shift = m_depth - l;
+      cell = 8 * cell + 1 + child_slot(walk.voxel.x >> shift, walk.voxel.y >> shift, walk.voxel.z >> shift);
+      walk.stack[l] = int(m_nodes.size() + cell);
+    }
+    walk.level = m_levels - 1;
+  }
+
+  /**
+   * @brief Value of a voxel, indexing the bottom implicit level directly.
+   * @param v Voxel coordinate, each axis in [0, 2^depth).
+   */
+  inline int lookup(glm::uvec3 v) const {
+    if (m_nodes.empty()) return 0;
+    int value = 1;
+    uint32_t level = 0;
+    if (m_levels > 0) {
+      uint64_t morton = 0;
+      for (uint32_t l = 0; l < m_levels; ++l) {
+        const uint32_t shift = m_depth - l - 1;
+        morton = morton << 3 | child_slot(v.x >> shift, v.y >> shift, v.z >> shift);
+      }
+      value = m_roots[morton];
+      level = m_levels;
+    }
+    for (; level < m_depth && value > 0; ++level) {
+      const uint32_t shift = m_depth - level - 1;
+      value = m_nodes[value - 1].children[child_slot(v.x >> shift, v.y >> shift, v.z >> shift)];
+    }
+    return value > 0 ? 0 : value;
+  }
+
+  /// Bytes held by the implicit levels.
+  inline size_t memory_usage() const { return m_masks.size() + m_roots.size() * sizeof(int); }
+
+private:
+  std::span<const node_t<int>> m_nodes;
+  uint32_t                     m_depth  = 0;
+  uint32_t                     m_levels = 0;
+  uint64_t                     m_last   = 0; ///< First cell of the bottom implicit level.
+  std::vector<uint8_t>         m_masks;      ///< Occupancy byte per implicit cell, heap order.
+  std::vector<int>             m_roots;      ///< Child values below the bottom implicit level, Morton order.
+};
+
+/**
+ * @brief `query_point` through the implicit top levels.
+ */
+inline int query_point(const implicit_top_levels& top, const pool_frame_t& frame, glm::vec3 p) {
+  const float res = float(1u << frame.depth);
+  const glm::vec3 g = glm::floor((p - frame.corner) / frame.size * res);
+  if (g.x < 0 || g.y < 0 || g.z < 0 || g.x >= res || g.y >= res || g.z >= res)
+    return 0;
+  return top.lookup(glm::uvec3(g));
+}
+
+/**
+ * @brief `query_ray_fixed` through the implicit top levels.
+ */
+inline std::optional<float> query_ray(const implicit_top_levels& top, const pool_frame_t& frame,
+                                      glm::vec3 o, glm::vec3 d, float max_dist) {
+  if (top.empty() || frame.depth == 0 || frame.depth > 30) return std::nullopt;
+  const fixed_ray_t ray(frame, o, d);
+  fixed_walk_t walk;
+  int64_t t0, t1;
+  if (!detail::fixed_enter(frame, ray, max_dist, t0, t1, walk.voxel)) return std::nullopt;
+  top.seed(walk);
+  if (auto t = detail::fixed_walk(top, frame.depth, ray, t0, t1, walk))
+    return float((double(*t) / fixed_ray_t::one + ray.t_base) / ray.scale);
+  return std::nullopt;
+}
+
+} // namespace oasis
+
+#endif // NODE_POOL_IMPLICIT_TOP_HPP
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_LINE_OF_SIGHT_HPP
+#define NODE_POOL_LINE_OF_SIGHT_HPP
+
+#include <oasis/node_pool_fixed_traversal.hpp>
+#include <oasis/node_pool_queries.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace oasis {
+
+/**
+ * @struct sight_bits_t
+ * @brief One bit per segment of a `line_of_sight` batch: set if the segment is clear.
+ */
+struct sight_bits_t {
+  std::vector<uint64_t> words;
+  size_t                size = 0;
+
+  inline bool visible(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+
+  inline bool operator[](size_t i) const { return visible(i); }
+
+  /// Clear segments.
+  inline size_t count() const {
+    size_t n = 0;
+    for (uint64_t w : words) n += size_t(std::popcount(w));
+    return n;
+  }
+};
+
+namespace detail {
+
+/// Interleaves the bits of a voxel coordinate (x lowest), for grouping nearby endpoints.
+inline uint64_t morton3(glm::uvec3 v) {
+  auto spread = [](uint64_t x) {
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffffull;
+    x = (x | x << 16) & 0x1f0000ff0000ffull;
+    x = (x | x << 8) & 0x100f00f00f00f00full;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+    x = (x | x << 2) & 0x1249249249249249ull;
+    return x;
+  };
+  return spread(v.x) | spread(v.y) << 1 | spread(v.z) << 2;
+}
+
+} // namespace detail
+
+/**
+ * @brief Tests many segments for occlusion at once.
+ *
+ * A segment is clear if no solid voxel touches it, the voxels of its end
+ * points included. Each segment stops at the first solid voxel; no hit
+ * distance is computed. Segments are oriented and sorted so that ones
+ * sharing an end point (e.g. one agent checking many targets) run one
+ * after another on the same thread, each restarting from the node path
+ * the previous one left (as in `traversal_context`) instead of the root.
+ *
+ * @param segments End point pairs in world space.
+ * @param threads Worker threads (0 = hardware concurrency).
+ * @return Bit `i` set if segment `i` is clear.
+ */
+inline sight_bits_t line_of_sight(std::span<const node_t<int>> nodes, const pool_frame_t& frame,
+                                  std::span<const std::pair<glm::vec3, glm::vec3>> segments,
+                                  uint32_t threads = 0) {
+  sight_bits_t out;
+  out.size = segments.size();
+  out.words.assign((segments.size() + 63) / 64, 0);
+  if (segments.empty()) return out;
+  if (nodes.empty() || frame.depth == 0 || frame.depth > 30) {
+    // Nothing can block
+    for (size_t i = 0; i < segments.size(); ++i)
+      out.words[i / 64] |= uint64_t(1) << (i % 64);
+    return out;
+  }
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+  // Orient every segment from its lower Morton end point and group by that
+  // point (top 10 bits per axis), radix sorting (key << 32 | segment) words
+  const uint32_t bits = std::min(frame.depth, 10u);
+  const float cells = float(1u << bits), scale = cells / frame.size;
+  auto key = [&](glm::vec3 p) {
+    glm::uvec3 g;
+    for (int a = 0; a < 3; ++a)
+      g[a] = uint32_t(std::clamp((p[a] - frame.corner[a]) * scale, 0.0f, cells - 1.0f));
+    return detail::morton3(g);
+  };
+  std::vector<uint64_t> order(segments.size()), scratch(segments.size());
+  std::vector<uint8_t> flip(segments.size());
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const uint64_t a = key(segments[i].first), b = key(segments[i].second);
+    flip[i] = b < a;
+    order[i] = std::min(a, b) << 32 | i;
+  }
+  for (uint32_t shift = 32; shift < 64; shift += 8) {
+    size_t offsets[257] = {0};
+    for (uint64_t w : order) ++offsets[((w >> shift) & 0xff) + 1];
+    for (int b = 0; b < 256; ++b) offsets[b + 1] += offsets[b];
+    for (uint64_t w : order) scratch[offsets[(w >> shift) & 0xff]++] = w;
+    order.swap(scratch);
+  }
+
+  const size_t count = std::min<size_t>(threads, (order.size() + 255) / 256);
+  auto work = [&](size_t part) {
+    const size_t begin = order.size() * part / count, end = order.size() * (part + 1) / count;
+    fixed_walk_t walk;
+    for (size_t k = begin; k < end; ++k) {
+      const size_t i = uint32_t(order[k]);
+      glm::vec3 a = segments[i].first, b = segments[i].second;
+      if (flip[i]) std::swap(a, b);
+
+      bool clear;
+      const float length = glm::length(b - a);
+      if (length <= 0.0f) {
+        clear = query_point(nodes, frame, a) == 0;
+      } else {
+        const fixed_ray_t ray(frame, a, (b - a) / length);
+        int64_t t0, t1;
+        glm::uvec3 v;
+        if (!detail::fixed_enter(frame, ray, length, t0, t1, v)) {
+          clear = true;
+        } else {
+          // Restart below the deepest node shared with the previous segment's end
+          const uint32_t diff = (v.x ^ walk.voxel.x) | (v.y ^ walk.voxel.y) | (v.z ^ walk.voxel.z);
+          walk.level = std::min(walk.level, frame.depth - uint32_t(std::bit_width(diff)));
+          walk.voxel = v;
+          clear = !detail::fixed_walk(nodes, frame.depth, ray, t0, t1, walk);
+        }
+      }
+      if (clear)
+        std::atomic_ref<uint64_t>(out.words[i / 64]).fetch_or(uint64_t(1) << (i % 64), std::memory_order_relaxed);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (size_t part = 1; part < count; ++part)
+    pool.emplace_back(work, part);
+  work(0);
+  for (auto& th : pool) th.join();
+  return out;
+}
+
+} // namespace oasis
+
+#endif // NODE_POOL_LINE_OF_SIGHT_HPP
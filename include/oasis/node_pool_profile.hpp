@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_PROFILE_HPP
+#define NODE_POOL_PROFILE_HPP
+
+#include <oasis/node_pool_fixed_traversal.hpp>
+#include <algorithm>
+#include <numeric>
+#include <span>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace oasis {
+
+/**
+ * @class access_counter
+ * @brief Per-thread node read counters for a sample of rays.
+ *
+ * Each tracing thread owns one counter, so counting needs no atomics;
+ * the counters are merged into an `access_profile` afterwards.
+ */
+class access_counter {
+public:
+  /**
+   * @param nodes Pool size.
+   * @param sample_every Rays per sampled ray.
+   */
+  inline explicit access_counter(size_t nodes, uint32_t sample_every = 8)
+    : m_counts(nodes, 0), m_sample_every(std::max(1u, sample_every)) {}
+
+  /// Makes a traversal context count into this counter.
+  inline void attach(traversal_context& context) { context.profile(m_counts.data(), m_sample_every); }
+
+  /// Counts one read of a node, for traversals other than `traversal_context`.
+  inline void record(size_t index) { ++m_counts[index]; }
+
+  inline std::span<const uint32_t> counts() const { return m_counts; }
+
+  inline uint32_t sample_every() const { return m_sample_every; }
+
+  inline void clear() { std::fill(m_counts.begin(), m_counts.end(), 0u); }
+
+private:
+  std::vector<uint32_t> m_counts;
+  uint32_t              m_sample_every;
+};
+
+/**
+ * @class access_profile
+ * @brief Estimated node read counts, merged from per-thread counters.
+ *
+ * Drives the node layout (`profile_order`) and the paging policy
+ * (`page_ranking`, `advise_hot_pages`). Merging is not thread-safe:
+ * merge once the tracing threads are done.
+ */
+class access_profile {
+public:
+  inline explicit access_profile(size_t nodes = 0) : m_counts(nodes, 0) {}
+
+  /// Adds a counter, scaled by its sampling rate.
+  inline void merge(const access_counter& counter) {
+    const auto counts = counter.counts();
+    if (m_counts.size() < counts.size()) m_counts.resize(counts.size(), 0);
+    for (size_t i = 0; i < counts.size(); ++i)
+      m_counts[i] += uint64_t(counts[i]) * counter.sample_every();
+  }
+
+  inline std::span<const uint64_t> counts() const { return m_counts; }
+
+  inline uint64_t total() const { return std::accumulate(m_counts.begin(), m_counts.end(), uint64_t(0)); }
+
+  /**
+   * @brief Moves the counts along with the nodes.
+   * @param order The order the nodes were laid out in (see `apply_order`).
+   */
+  inline void remap(std::span<const int> order) {
+    std::vector<uint64_t> counts(order.size(), 0);
+    for (size_t k = 0; k < order.size(); ++k)
+      counts[k] = size_t(order[k]) < m_counts.size() ? m_counts[order[k]] : 0;
+    m_counts = std::move(counts);
+  }
+
+  /**
+   * @brief Pages of the node array, hottest first.
+   * @param page_bytes Page size.
+   */
+  inline std::vector<size_t> page_ranking(size_t page_bytes) const {
+    const size_t per_page = std::max<size_t>(1, page_bytes / sizeof(node_t<int>));
+    std::vector<uint64_t> heat((m_counts.size() + per_page - 1) / per_page, 0);
+    for (size_t i = 0; i < m_counts.size(); ++i)
+      heat[i / per_page] += m_counts[i];
+    std::vector<size_t> pages(heat.size());
+    std::iota(pages.begin(), pages.end(), size_t(0));
+    std::stable_sort(pages.begin(), pages.end(), [&](size_t a, size_t b) { return heat[a] > heat[b]; });
+    while (!pages.empty() && heat[pages.back()] == 0)
+      pages.pop_back();
+    return pages;
+  }
+
+  /// Fewest pages that together take `share` of all reads.
+  inline size_t pages_for_share(size_t page_bytes, double share) const {
+    const size_t per_page = std::max<size_t>(1, page_bytes / sizeof(node_t<int>));
+    std::vector<uint64_t> heat((m_counts.size() + per_page - 1) / per_page, 0);
+    for (size_t i = 0; i < m_counts.size(); ++i)
+      heat[i / per_page] += m_counts[i];
+    std::sort(heat.begin(), heat.end(), std::greater<>());
+    const double goal = share * double(total());
+    double sum = 0.0;
+    size_t pages = 0;
+    while (pages < heat.size() && sum < goal)
+      sum += double(heat[pages++]);
+    return pages;
+  }
+
+private:
+  std::vector<uint64_t> m_counts;
+};
+
+/**
+ * @brief Reachable nodes in depth-first (pre-)order, root first.
+ *
+ * Shared nodes are placed at their first visit, so one may come before
+ * some of its parents; `profile_order` keeps parents first.
+ */
+inline std::vector<int> depth_first_order(std::span<const node_t<int>> nodes) {
+  std::vector<int> order;
+  if (nodes.empty()) return order;
+  std::vector<bool> seen(nodes.size(), false);
+  std::vector<int> pending{0};
+  seen[0] = true;
+  while (!pending.empty()) {
+    const int i = pending.back();
+    pending.pop_back();
+    order.push_back(i);
+    for (int slot = 7; slot >= 0; --slot) {
+      const int child = nodes[i].children[slot];
+      if (child > 0 && !seen[child - 1]) {
+        seen[child - 1] = true;
+        pending.push_back(child - 1);
+      }
+    }
+  }
+  return order;
+}
+
+/**
+ * @brief Profile-guided node order: the hottest nodes packed first.
+ *
+ * The fewest nodes that take `hot_share` of the profiled reads go first,
+ * together with every ancestor of those nodes, so that no node comes
+ * before one of its parents (the order builders, `build_sequence` and
+ * the finalize remap rely on). Both the hot and the remaining reachable
+ * nodes are in depth-first topological order: a node is placed once its
+ * last parent has been, so a path stays close. The root stays first.
+ */
+inline std::vector<int> profile_order(std::span<const node_t<int>> nodes, const access_profile& profile,
+                                      double hot_share = 0.9) {
+  std::vector<int> order;
+  if (nodes.empty()) return order;
+  const auto counts = profile.counts();
+  auto count = [&](int i) { return size_t(i) < counts.size() ? counts[i] : 0; };
+
+  // References from reachable nodes, then a depth-first walk that places a node after its last parent
+  std::vector<uint32_t> parents(nodes.size(), 0);
+  for (int i : depth_first_order(nodes)) {
+    for (int child : nodes[i].children) {
+      if (child > 0) ++parents[child - 1];
+    }
+  }
+  std::vector<int> pending{0};
+  while (!pending.empty()) {
+    const int i = pending.back();
+    pending.pop_back();
+    order.push_back(i);
+    for (int slot = 7; slot >= 0; --slot) {
+      const int child = nodes[i].children[slot];
+      if (child > 0 && --parents[child - 1] == 0) pending.push_back(child - 1);
+    }
+  }
+
+  std::vector<int> by_heat(order);
+  std::stable_sort(by_heat.begin(), by_heat.end(), [&](int a, int b) { return count(a) > count(b); });
+  const double goal = hot_share * double(profile.total());
+  std::vector<bool> hot(nodes.size(), false);
+  double sum = 0.0;
+  for (int i : by_heat) {
+    if (sum >= goal || count(i) == 0) break;
+    hot[i] = true;
+    sum += double(count(i));
+  }
+  // Children before parents: a parent of a hot node is hot
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    for (int child : nodes[*it].children) {
+      if (child > 0 && hot[child - 1]) hot[*it] = true;
+    }
+  }
+  hot[0] = true;
+
+  std::stable_partition(order.begin(), order.end(), [&](int i) { return bool(hot[i]); });
+  return order;
+}
+
+/**
+ * @brief Lays the nodes out in a given order.
+ * @param order Old indices in their new order, root first (unlisted nodes are dropped).
+ */
+inline std::vector<node_t<int>> apply_order(std::span<const node_t<int>> nodes, std::span<const int> order) {
+  std::vector<int> remap(nodes.size(), 0);
+  for (size_t k = 0; k < order.size(); ++k)
+    remap[order[k]] = int(k) + 1;
+  std::vector<node_t<int>> out(order.size());
+  for (size_t k = 0; k < order.size(); ++k) {
+    out[k] = nodes[order[k]];
+    for (auto& child : out[k].children) {
+      if (child > 0) child = remap[child - 1];
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Asks the kernel to bring the hottest pages of a mapped node array into memory.
+ *
+ * For page-aligned node arrays mapped from a file or shared segment
+ * (e.g. a `node_pool_client`'s nodes), laid out by `profile_order`.
+ *
+ * @param ranking Pages hottest first, from `access_profile::page_ranking` with the system page size.
+ * @param pages How many of them to prefetch.
+ */
+inline void advise_hot_pages(std::span<const node_t<int>> nodes, std::span<const size_t> ranking, size_t pages) {
+  const size_t page = size_t(sysconf(_SC_PAGESIZE));
+  const uintptr_t base = reinterpret_cast<uintptr_t>(nodes.data());
+  const uintptr_t end = reinterpret_cast<uintptr_t>(nodes.data() + nodes.size());
+  for (size_t k = 0; k < std::min(pages, ranking.size()); ++k) {
+    const uintptr_t at = base + ranking[k] * page;
+    if (at < end) madvise(reinterpret_cast<void*>(at), page, MADV_WILLNEED);
+  }
+}
+
+} // namespace oasis
+
+#endif // NODE_POOL_PROFILE_HPP
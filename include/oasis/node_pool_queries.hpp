@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_QUERIES_HPP
+#define NODE_POOL_QUERIES_HPP
+
+#include <oasis/node_pool.hpp>
+#include <oasis/node_pool_view.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @struct pool_frame_t
+ * @brief Where a pool sits in world space.
+ *
+ * A pool built with `build(scene, depth, corner, size)` covers the cube
+ * [corner, corner + size] with 2^depth voxels per axis.
+ */
+struct pool_frame_t {
+  glm::vec3 corner = glm::vec3(0.0f);
+  float     size   = 1.0f;
+  uint32_t  depth  = 0;
+};
+
+/// Child slot of an octant offset: x in bit 0, y in bit 1, z in bit 2.
+constexpr uint32_t child_slot(uint32_t x, uint32_t y, uint32_t z) {
+  return (x & 1) | ((z & 1) << 2) | ((y & 1) << 1);
+}
+
+/// Minimum-corner offset of a child slot, in units of the child size.
+inline glm::vec3 child_offset(uint32_t slot) {
+  return glm::vec3(float(slot & 1), float((slot >> 1) & 1), float((slot >> 2) & 1));
+}
+
+/**
+ * @brief Looks up the value at a world-space point.
+ *
+ * Works on any node span in the pool encoding (root at index 0, child
+ * value 0 empty, negative a solid leaf, positive node index + 1), so it
+ * can run on memory the caller does not own, such as a shared mapping.
+ *
+ * @return The leaf value, or 0 if the point is empty or outside the frame.
+ */
+inline int query_point(std::span<const node_t<int>> nodes, const pool_frame_t& frame, glm::vec3 p) {
+  if (nodes.empty()) return 0;
+  const float res = float(1u << frame.depth);
+  const glm::vec3 g = glm::floor((p - frame.corner) / frame.size * res);
+  if (g.x < 0 || g.y < 0 || g.z < 0 || g.x >= res || g.y >= res || g.z >= res)
+    return 0;
+  return node_pool_view<int>(nodes).lookup(glm::uvec3(g), frame.depth);
+}
+
+/**
+ * @brief Tests whether any solid voxel overlaps a world-space box.
+ */
+inline bool query_box(std::span<const node_t<int>> nodes, const pool_frame_t& frame, 
+                      glm::vec3 min, glm::vec3 max) {
+  if (nodes.empty()) return false;
+
+  struct entry_t { int node; uint32_t level; glm::vec3 corner; float size; };
+  entry_t stack[8 * 32];
+  int top = 0;
+  stack[top++] = {0, 0, frame.corner, frame.size};
+
+  while (top > 0) {
+    const entry_t e = stack[--top];
+    const float h = e.size * 0.5f;
+    for (uint32_t i = 0; i < 8; ++i) {
+      const int child = nodes[e.node].children[i];
+      if (child == 0) continue;
+      const glm::vec3 c = e.corner + child_offset(i) * h;
+      if (glm::any(glm::greaterThanEqual(c, max)) || glm::any(glm::lessThanEqual(c + h, min)))
+        continue;
+      if (child < 0) return true;
+      if (e.level + 1 < frame.depth)
+        stack[top++] = {child - 1, e.level + 1, c, h};
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Casts a ray against the solid voxels of a node span.
+ *
+ * Children are visited front to back by their entry distance, so the
+ * first leaf reached is the closest hit.
+ *
+ * @param o Ray origin in world space.
+ * @param d Ray direction. Need not be normalized: it is normalized here, so
+ *        `max_dist` and the result are world distances, as in `query_ray_fixed`.
+ * @param max_dist Maximum hit distance.
+ * @return The hit distance, or `std::nullopt` if nothing is hit.
+ */
+inline std::optional<float> query_ray(std::span<const node_t<int>> nodes, const pool_frame_t& frame,
+                                      glm::vec3 o, glm::vec3 d, float max_dist) {
+  if (nodes.empty() || glm::dot(d, d) == 0.0f) return std::nullopt;
+  d = glm::normalize(d);
+  const glm::vec3 inv = 1.0f / d;
+
+  auto slab = [&](glm::vec3 c, float s, float& t0, float& t1) {
+    t0 = 0.0f;
+    t1 = max_dist;
+    for (int k = 0; k < 3; ++k) {
+      if (d[k] == 0.0f) {
+        // Parallel to the slab (0 * inf would be NaN): inside it or never
+        if (o[k] < c[k] || o[k] >= c[k] + s) return false;
+        continue;
+      }
+      const float a = (c[k] - o[k]) * inv[k], b = (c[k] + s - o[k]) * inv[k];
+      t0 = std::max(t0, std::min(a, b));
+      t1 = std::min(t1, std::max(a, b));
+    }
+    return t0 <= t1;
+  };
+
+  struct entry_t { int node; uint32_t level; glm::vec3 corner; float size; float t; };
+  entry_t stack[8 * 32];
+  int top = 0;
+  float t0, t1;
+  if (!slab(frame.corner, frame.size, t0, t1)) return std::nullopt;
+  stack[top++] = {0, 0, frame.corner, frame.size, t0};
+
+  while (top > 0) {
+    const entry_t e = stack[--top];
+    if (e.node < 0) return e.t;
+    const float h = e.size * 0.5f;
+
+    // A ray crosses at most 4 children
+    entry_t hits[8];
+    int count = 0;
+    for (uint32_t i = 0; i < 8; ++i) {
+      const int child = nodes[e.node].children[i];
+      if (child == 0 || (child > 0 && e.level + 1 >= frame.depth)) continue;
+      const glm::vec3 c = e.corner + child_offset(i) * h;
+      if (slab(c, h, t0, t1))
+        hits[count++] = {child > 0 ? child - 1 : child, e.level + 1, c, h, t0};
+    }
+    std::sort(hits, hits + count, [](const entry_t& a, const entry_t& b) { return a.t < b.t; });
+
+    // Push far to near so the nearest child is visited first
+    for (int k = count; k-- > 0;)
+      stack[top++] = hits[k];
+  }
+  return std::nullopt;
+}
+
+} // namespace oasis
+
+#endif // NODE_POOL_QUERIES_HPP
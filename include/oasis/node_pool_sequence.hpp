@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_SEQUENCE_HPP
+#define NODE_POOL_SEQUENCE_HPP
+
+#include <oasis/node_pool.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace oasis {
+
+namespace detail {
+
+/**
+ * @class concurrent_dedup
+ * @brief Node dedup table that many threads insert into at once.
+ *
+ * Split into shards by node hash, each with its own lock, node list and
+ * map, so threads inserting different nodes rarely wait on each other.
+ * A node's id packs its shard in the low bits; `flatten` turns the
+ * shards into one node array.
+ */
+class concurrent_dedup {
+public:
+  static constexpr uint32_t shard_bits = 6;
+  static constexpr uint32_t shards     = 1u << shard_bits;
+
+  /// Inserts a node whose inner children are values returned by `insert`; returns its child value.
+  inline int insert(const node_t<int>& node) {
+    const size_t h = std::hash<node_t<int>>{}(node);
+    const uint32_t s = uint32_t(h >> 7) & (shards - 1);
+    shard_t& shard = m_shards[s];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto [it, inserted] = shard.index.try_emplace(node, uint32_t(shard.nodes.size()));
+    if (inserted) shard.nodes.push_back(node);
+    return int((it->second << shard_bits) | s) + 1;
+  }
+
+  /// Unique nodes inserted so far.
+  inline size_t size() {
+    size_t n = 0;
+    for (auto& shard : m_shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      n += shard.nodes.size();
+    }
+    return n;
+  }
+
+  /**
+   * @brief Appends all nodes to `out`, rewriting child values to indices in `out`.
+   * @return A function mapping a value returned by `insert` to its child value in `out`.
+   */
+  inline std::function<int(int)> flatten(std::vector<node_t<int>>& out) {
+    std::array<size_t, shards> offset{};
+    size_t at = out.size();
+    for (uint32_t s = 0; s < shards; ++s) {
+      offset[s] = at;
+      at += m_shards[s].nodes.size();
+    }
+    auto remap = [offset](int value) {
+      if (value <= 0) return value;
+      const uint32_t id = uint32_t(value - 1);
+      return int(offset[id & (shards - 1)] + (id >> shard_bits)) + 1;
+    };
+    out.reserve(at);
+    for (auto& shard : m_shards) {
+      for (node_t<int> node : shard.nodes) {
+        for (auto& child : node.children)
+          child = remap(child);
+        out.push_back(node);
+      }
+    }
+    return remap;
+  }
+
+  inline void clear() {
+    for (auto& shard : m_shards) {
+      shard.index.clear();
+      shard.nodes.clear();
+    }
+  }
+
+private:
+  struct shard_t {
+    std::mutex                                mutex;
+    std::vector<node_t<int>>                  nodes;
+    std::unordered_map<node_t<int>, uint32_t> index; ///< Node -> position in `nodes`.
+  };
+  std::array<shard_t, shards> m_shards;
+};
+
+} // namespace detail
+
+/**
+ * @class node_pool_sequence
+ * @brief An animated voxel sequence: every frame is a root in one shared pool.
+ *
+ * Frames are built independently (in parallel) and merged through one
+ * concurrent dedup table, so geometry that does not change between
+ * frames is stored once and a sequence costs little more than its unique
+ * changes.
+ *
+ * Node 0 holds a copy of the selected frame's root and nothing else
+ * references it, so `select_frame` switches frames in O(1) and every
+ * kernel that expects the root at index 0 sees that frame.
+ */
+class node_pool_sequence : public virtual node_pool {
+public:
+  /// Builds one frame's pool (root at index 0); returns false on failure.
+  using frame_build_t = std::function<bool(size_t frame, std::vector<node_t<int>>& nodes)>;
+
+  /// Default constructor.
+  explicit node_pool_sequence() = default;
+
+  /**
+   * @brief Builds every frame and merges them into this pool.
+   *
+   * @param frames Number of frames.
+   * @param build Builds one frame; called concurrently from `threads` threads.
+   * @param threads Worker threads (0: hardware concurrency).
+   * @return False if a frame failed to build (it is left empty).
+   */
+  inline bool build_sequence(size_t frames, const frame_build_t& build, size_t threads = 0) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min(threads, frames));
+
+    detail::concurrent_dedup dedup;
+    std::vector<int> roots(frames, 0);
+    std::atomic<size_t> next{0};
+    std::atomic<bool> ok{true};
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&]() {
+        std::vector<node_t<int>> nodes;
+        std::vector<int> remap;
+        for (size_t f; (f = next.fetch_add(1)) < frames;) {
+          nodes.clear();
+          if (!build(f, nodes)) {
+            ok = false;
+            continue;
+          }
+          if (nodes.empty() || !nodes[0].has_value()) continue;
+
+          // Children have higher indices than their parents: insert bottom-up
+          remap.assign(nodes.size(), 0);
+          for (size_t i = nodes.size(); i-- > 0;) {
+            node_t<int> node = nodes[i];
+            for (auto& child : node.children) {
+              if (child > 0) child = remap[child - 1];
+            }
+            remap[i] = node.has_value() ? dedup.insert(node) : 0;
+          }
+          roots[f] = remap[0];
+        }
+      });
+    }
+    for (auto& worker : workers)
+      worker.join();
+
+    m_nodes.assign(1, node_t<int>::null());
+    const auto remap = dedup.flatten(m_nodes);
+    m_roots.resize(frames);
+    for (size_t f = 0; f < frames; ++f)
+      m_roots[f] = remap(roots[f]);
+    select_frame(0);
+    return ok;
+  }
+
+  inline size_t frame_count() const { return m_roots.size(); }
+
+  /// Root of a frame as a child value (0 if the frame is empty).
+  inline int frame_root(size_t frame) const { return m_roots[frame]; }
+
+  inline size_t selected_frame() const { return m_selected; }
+
+  /// Makes node 0 the root of `frame`.
+  inline void select_frame(size_t frame) {
+    if (frame >= m_roots.size() || m_nodes.empty()) return;
+    m_selected = frame;
+    const int root = m_roots[frame];
+    m_nodes[0] = root > 0 ? m_nodes[root - 1] : node_t<int>::null();
+  }
+
+  /// Nodes reachable from one frame, i.e. what a standalone pool of the frame would hold.
+  inline size_t frame_node_count(size_t frame) const {
+    const int root = m_roots[frame];
+    if (root <= 0) return 0;
+    std::vector<bool> seen(m_nodes.size(), false);
+    std::vector<int> pending{root - 1};
+    seen[root - 1] = true;
+    size_t count = 0;
+    while (!pending.empty()) {
+      const int i = pending.back();
+      pending.pop_back();
+      ++count;
+      for (int child : m_nodes[i].children) {
+        if (child > 0 && !seen[child - 1]) {
+          seen[child - 1] = true;
+          pending.push_back(child - 1);
+        }
+      }
+    }
+    return count;
+  }
+
+  /**
+   * @brief Writes the sequence: frame count, frame roots, then the pool file.
+   */
+  inline bool write_sequence(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    const size_t frames = m_roots.size(), count = m_nodes.size();
+    out.write(reinterpret_cast<const char*>(&frames), sizeof(frames));
+    out.write(reinterpret_cast<const char*>(m_roots.data()), frames * sizeof(int));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(m_nodes.data()), count * sizeof(node_t<int>));
+    return bool(out);
+  }
+
+  /// Reads a file written by `write_sequence` and selects frame 0.
+  inline bool read_sequence(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    size_t frames = 0, count = 0;
+    if (!in.read(reinterpret_cast<char*>(&frames), sizeof(frames))) return false;
+    m_roots.resize(frames);
+    if (!in.read(reinterpret_cast<char*>(m_roots.data()), frames * sizeof(int))) return false;
+    if (!in.read(reinterpret_cast<char*>(&count), sizeof(count))) return false;
+    m_nodes.resize(count);
+    if (!in.read(reinterpret_cast<char*>(m_nodes.data()), count * sizeof(node_t<int>))) return false;
+    select_frame(0);
+    return true;
+  }
+
+private:
+  std::vector<int> m_roots;        ///< Root child value per frame.
+  size_t           m_selected = 0; ///< Frame whose root is copied into node 0.
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_SEQUENCE_HPP
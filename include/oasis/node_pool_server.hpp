@@ -0,0 +1,532 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_SERVER_HPP
+#define NODE_POOL_SERVER_HPP
+
+#include <oasis/node_pool_queries.hpp>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace oasis {
+
+/**
+ * @enum pool_query_type_t
+ * @brief Kind of query sent to a pool server.
+ */
+enum class pool_query_type_t : uint32_t {
+  ray,   ///< a = origin, b = direction, max_dist: hit distance.
+  point, ///< a = point: leaf value.
+  box    ///< a = min, b = max: whether any voxel overlaps.
+};
+
+/**
+ * @struct pool_query_t
+ * @brief One query as it travels through a shared-memory ring.
+ */
+struct pool_query_t {
+  uint64_t          id;         ///< Caller tag, echoed in the result.
+  pool_query_type_t type;
+  uint32_t          generation; ///< Slot generation of the sender (set by `node_pool_client::run`).
+  float             a[3];
+  float             b[3];
+  float             max_dist;
+};
+
+/**
+ * @struct pool_result_t
+ * @brief Answer to one `pool_query_t`.
+ */
+struct pool_result_t {
+  uint64_t id;         ///< Tag of the query.
+  int32_t  hit;        ///< Ray/box: 1 if hit; point: the leaf value (0 if empty).
+  float    dist;       ///< Ray: hit distance.
+  uint32_t generation; ///< Generation of the query.
+};
+
+/**
+ * @class pool_ring
+ * @brief Single-producer single-consumer ring living in shared memory.
+ *
+ * Only trivially copyable data and lock-free atomics are stored, so the
+ * ring works across processes that map the segment at different addresses.
+ */
+template <typename T>
+struct pool_ring {
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  alignas(64) std::atomic<uint64_t> head; ///< Next slot to write (producer).
+  alignas(64) std::atomic<uint64_t> tail; ///< Next slot to read (consumer).
+  alignas(64) uint64_t              capacity;
+  T                                 items[1]; ///< `capacity` entries follow.
+
+  static constexpr size_t bytes(uint64_t capacity) {
+    return (offsetof(pool_ring, items) + capacity * sizeof(T) + 63) & ~size_t(63);
+  }
+
+  /// Pushes as many items as fit; returns how many were pushed.
+  inline size_t push(std::span<const T> in) {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    const uint64_t t = tail.load(std::memory_order_acquire);
+    const size_t n = std::min<size_t>(in.size(), capacity - (h - t));
+    for (size_t i = 0; i < n; ++i)
+      items[(h + i) & (capacity - 1)] = in[i];
+    head.store(h + n, std::memory_order_release);
+    return n;
+  }
+
+  /// Pops up to `out.size()` items; returns how many were popped.
+  inline size_t pop(std::span<T> out) {
+    const uint64_t t = tail.load(std::memory_order_relaxed);
+    const uint64_t h = head.load(std::memory_order_acquire);
+    const size_t n = std::min<size_t>(out.size(), h - t);
+    for (size_t i = 0; i < n; ++i)
+      out[i] = items[(t + i) & (capacity - 1)];
+    tail.store(t + n, std::memory_order_release);
+    return n;
+  }
+};
+
+/**
+ * @struct pool_segment_header_t
+ * @brief Start of a pool server's shared-memory segment.
+ *
+ * Layout: header, nodes (page aligned, so clients can map them read-only
+ * on their own), then one request ring and one result ring per client slot.
+ *
+ * A slot is owned by the pid in `slots_used`. A client that finds a slot
+ * whose owner died takes it over and bumps the slot's generation; the
+ * server drops queries of older generations and the client drops their
+ * results, so nothing left in the rings by the dead client leaks through.
+ */
+struct pool_segment_header_t {
+  static constexpr uint32_t magic_value   = 0x4c4f4f50; // "POOL"
+  static constexpr uint32_t version_value = 2;
+
+  uint32_t              magic;
+  uint32_t              version;
+  pool_frame_t          frame;
+  uint64_t              node_count;
+  uint64_t              nodes_offset;
+  uint64_t              rings_offset;
+  uint64_t              ring_capacity;
+  uint32_t              slot_count;
+  std::atomic<uint32_t> ready;           ///< Set once the segment is filled.
+  std::atomic<uint32_t> slots_used[64];  ///< Pid of the client owning the slot, 0 if free.
+  std::atomic<uint32_t> generation[64];  ///< Bumped each time a slot changes owner.
+};
+
+namespace detail {
+
+inline size_t page_align(size_t n) {
+  const size_t page = size_t(sysconf(_SC_PAGESIZE));
+  return (n + page - 1) / page * page;
+}
+
+inline size_t slot_bytes(uint64_t capacity) {
+  return pool_ring<pool_query_t>::bytes(capacity) + pool_ring<pool_result_t>::bytes(capacity);
+}
+
+/// Spins briefly, then sleeps for exponentially longer (up to 1 ms) while there is no work.
+struct idle_backoff {
+  uint32_t rounds = 0;
+
+  inline void wait() {
+    if (rounds < 64)
+      std::this_thread::yield();
+    else
+      std::this_thread::sleep_for(std::chrono::microseconds(1u << std::min(rounds - 64, 10u)));
+    ++rounds;
+  }
+
+  inline void reset() { rounds = 0; }
+};
+
+} // namespace detail
+
+/**
+ * @class node_pool_server
+ * @brief Serves one pool from a named shared-memory segment.
+ *
+ * The nodes are copied once into the segment; every process on the host
+ * then shares the same physical pages. Clients either send batches of
+ * queries through their slot's rings or map the nodes read-only and run
+ * `query_ray` / `query_point` / `query_box` themselves.
+ */
+class node_pool_server {
+public:
+  inline explicit node_pool_server() = default;
+  inline ~node_pool_server() { close(); }
+
+  node_pool_server(const node_pool_server&) = delete;
+  node_pool_server& operator=(const node_pool_server&) = delete;
+
+  /**
+   * @brief Creates the segment and copies the nodes into it.
+   *
+   * @param name Segment name (as for `shm_open`, e.g. "/oasis_pool").
+   * @param nodes Pool nodes, root at index 0.
+   * @param frame Where the pool sits in world space.
+   * @param slots Number of concurrent clients (at most 64).
+   * @param capacity Ring size per slot, rounded up to a power of two.
+   * @param replace Remove an existing segment of the same name first. Otherwise
+   *        creation fails (with `errno == EEXIST`) so a running server is not cut off.
+   * @return False if the segment could not be created.
+   */
+  inline bool create(const std::string& name, std::span<const node_t<int>> nodes, const pool_frame_t& frame,
+                     uint32_t slots = 16, uint64_t capacity = 4096, bool replace = false) {
+    close();
+    slots = std::clamp(slots, 1u, 64u);
+    uint64_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+
+    const size_t nodes_offset = detail::page_align(sizeof(pool_segment_header_t));
+    const size_t rings_offset = detail::page_align(nodes_offset + nodes.size_bytes());
+    m_bytes = rings_offset + slots * detail::slot_bytes(cap);
+
+    if (replace) shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return false;
+    if (ftruncate(fd, off_t(m_bytes)) != 0) {
+      ::close(fd);
+      shm_unlink(name.c_str());
+      return false;
+    }
+    void* base = mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+      shm_unlink(name.c_str());
+      return false;
+    }
+    m_base = static_cast<char*>(base);
+    m_name = name;
+
+    auto* header = new (m_base) pool_segment_header_t{};
+    header->magic = pool_segment_header_t::magic_value;
+    header->version = pool_segment_header_t::version_value;
+    header->frame = frame;
+    header->node_count = nodes.size();
+    header->nodes_offset = nodes_offset;
+    header->rings_offset = rings_offset;
+    header->ring_capacity = cap;
+    header->slot_count = slots;
+    std::memcpy(m_base + nodes_offset, nodes.data(), nodes.size_bytes());
+
+    for (uint32_t s = 0; s < slots; ++s) {
+      char* slot = m_base + rings_offset + s * detail::slot_bytes(cap);
+      auto* req = new (slot) pool_ring<pool_query_t>{};
+      auto* res = new (slot + pool_ring<pool_query_t>::bytes(cap)) pool_ring<pool_result_t>{};
+      req->capacity = cap;
+      res->capacity = cap;
+    }
+    header->ready.store(1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Answers queries until `stop` is set.
+   *
+   * Each thread owns every `threads`-th slot and drains its request ring
+   * in batches, so a slot is only ever consumed by one thread. Threads
+   * with nothing to do back off to sleeping, so an idle server costs
+   * little CPU; the first batch after a pause waits up to 1 ms.
+   */
+  inline void serve(const std::atomic<bool>& stop, uint32_t threads = 0) {
+    if (!m_base) return;
+    const auto* header = reinterpret_cast<const pool_segment_header_t*>(m_base);
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, header->slot_count);
+
+    std::vector<std::thread> pool;
+    for (uint32_t t = 0; t < threads; ++t) {
+      pool.emplace_back([this, header, t, threads, &stop]() {
+        const std::span<const node_t<int>> nodes(
+          reinterpret_cast<const node_t<int>*>(m_base + header->nodes_offset), header->node_count);
+        std::vector<pool_query_t> queries(256);
+        std::vector<pool_result_t> results(256);
+        detail::idle_backoff idle;
+        while (!stop.load(std::memory_order_relaxed)) {
+          bool busy = false;
+          for (uint32_t s = t; s < header->slot_count; s += threads) {
+            auto [req, res] = rings(s);
+            const size_t popped = req->pop(queries);
+            if (popped == 0) continue;
+            busy = true;
+
+            // Queries left behind by a previous owner of the slot get no answer
+            const uint32_t generation = header->generation[s].load(std::memory_order_acquire);
+            size_t n = 0;
+            for (size_t i = 0; i < popped; ++i) {
+              if (queries[i].generation == generation)
+                results[n++] = answer(nodes, header->frame, queries[i]);
+            }
+            // The client sized its batch to the ring; wait if it is slow to drain
+            detail::idle_backoff full;
+            for (size_t done = 0; done < n && !stop.load(std::memory_order_relaxed);) {
+              const size_t pushed = res->push(std::span<const pool_result_t>(results.data() + done, n - done));
+              done += pushed;
+              if (pushed == 0) full.wait();
+            }
+          }
+          if (busy)
+            idle.reset();
+          else
+            idle.wait();
+        }
+      });
+    }
+    for (auto& th : pool) th.join();
+  }
+
+  /// Unmaps and removes the segment.
+  inline void close() {
+    if (m_base) {
+      munmap(m_base, m_bytes);
+      shm_unlink(m_name.c_str());
+      m_base = nullptr;
+    }
+  }
+
+  /// Answers one query against a node span.
+  static inline pool_result_t answer(std::span<const node_t<int>> nodes, const pool_frame_t& frame, 
+                                     const pool_query_t& q) {
+    const glm::vec3 a(q.a[0], q.a[1], q.a[2]), b(q.b[0], q.b[1], q.b[2]);
+    pool_result_t r{q.id, 0, 0.0f, q.generation};
+    switch (q.type) {
+    case pool_query_type_t::ray:
+      if (auto t = query_ray(nodes, frame, a, b, q.max_dist)) {
+        r.hit = 1;
+        r.dist = *t;
+      }
+      break;
+    case pool_query_type_t::point:
+      r.hit = query_point(nodes, frame, a);
+      break;
+    case pool_query_type_t::box:
+      r.hit = query_box(nodes, frame, a, b) ? 1 : 0;
+      break;
+    }
+    return r;
+  }
+
+private:
+  inline std::pair<pool_ring<pool_query_t>*, pool_ring<pool_result_t>*> rings(uint32_t s) const {
+    const auto* header = reinterpret_cast<const pool_segment_header_t*>(m_base);
+    char* slot = m_base + header->rings_offset + s * detail::slot_bytes(header->ring_capacity);
+    return {reinterpret_cast<pool_ring<pool_query_t>*>(slot),
+            reinterpret_cast<pool_ring<pool_result_t>*>(slot + pool_ring<pool_query_t>::bytes(header->ring_capacity))};
+  }
+
+  char*       m_base  = nullptr;
+  size_t      m_bytes = 0;
+  std::string m_name;
+};
+
+/**
+ * @class node_pool_client
+ * @brief Connects to a `node_pool_server` segment.
+ *
+ * The nodes are mapped read-only; `nodes()` and `frame()` can be passed
+ * straight to the span queries. `run` sends queries through the rings of
+ * a slot claimed at `open`, for callers that prefer not to traverse.
+ */
+class node_pool_client {
+public:
+  inline explicit node_pool_client() = default;
+  inline ~node_pool_client() { close(); }
+
+  node_pool_client(const node_pool_client&) = delete;
+  node_pool_client& operator=(const node_pool_client&) = delete;
+
+  /**
+   * @brief Maps a server's segment and claims a query slot.
+   * @param name Segment name passed to `node_pool_server::create`.
+   * @param claim_slot False to only map the nodes (no ring access).
+   * @return False if the segment is missing, not ready, or all slots are taken.
+   */
+  inline bool open(const std::string& name, bool claim_slot = true) {
+    close();
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(pool_segment_header_t)) {
+      ::close(fd);
+      return false;
+    }
+    m_bytes = size_t(st.st_size);
+    void* base = mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+      ::close(fd);
+      return false;
+    }
+    m_base = static_cast<char*>(base);
+    auto* header = reinterpret_cast<pool_segment_header_t*>(m_base);
+    if (header->magic != pool_segment_header_t::magic_value || header->version != pool_segment_header_t::version_value ||
+        !header->ready.load(std::memory_order_acquire)) {
+      ::close(fd);
+      close();
+      return false;
+    }
+
+    // Nodes get a separate read-only view of the same pages
+    const size_t node_bytes = header->node_count * sizeof(node_t<int>);
+    if (node_bytes > 0) {
+      void* nodes = mmap(nullptr, node_bytes, PROT_READ, MAP_SHARED, fd, off_t(header->nodes_offset));
+      if (nodes == MAP_FAILED) {
+        ::close(fd);
+        close();
+        return false;
+      }
+      m_nodes = std::span<const node_t<int>>(static_cast<const node_t<int>*>(nodes), header->node_count);
+    }
+    ::close(fd);
+
+    if (claim_slot) {
+      // A free slot, or failing that one whose owner died
+      const uint32_t pid = uint32_t(getpid());
+      for (int pass = 0; pass < 2 && m_slot < 0; ++pass) {
+        for (uint32_t s = 0; s < header->slot_count; ++s) {
+          uint32_t owner = header->slots_used[s].load(std::memory_order_relaxed);
+          if (owner != 0 && (pass == 0 || kill(pid_t(owner), 0) == 0 || errno != ESRCH))
+            continue;
+          if (header->slots_used[s].compare_exchange_strong(owner, pid)) {
+            m_slot = int(s);
+            break;
+          }
+        }
+      }
+      if (m_slot < 0) {
+        close();
+        return false;
+      }
+
+      // Invalidate whatever a previous owner left in the rings
+      m_generation = header->generation[m_slot].fetch_add(1, std::memory_order_acq_rel) + 1;
+      auto* res = result_ring();
+      res->tail.store(res->head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+    return true;
+  }
+
+  /// Releases the slot and unmaps the segment.
+  inline void close() {
+    if (!m_base) return;
+    auto* header = reinterpret_cast<pool_segment_header_t*>(m_base);
+    if (m_slot >= 0)
+      header->slots_used[m_slot].store(0, std::memory_order_release);
+    if (!m_nodes.empty())
+      munmap(const_cast<node_t<int>*>(m_nodes.data()), m_nodes.size_bytes());
+    munmap(m_base, m_bytes);
+    m_base = nullptr;
+    m_nodes = {};
+    m_slot = -1;
+  }
+
+  /// Read-only view of the shared nodes.
+  inline std::span<const node_t<int>> nodes() const { return m_nodes; }
+
+  /// Where the shared pool sits in world space.
+  inline pool_frame_t frame() const {
+    return reinterpret_cast<const pool_segment_header_t*>(m_base)->frame;
+  }
+
+  /**
+   * @brief Sends queries to the server and collects the answers.
+   *
+   * Queries are streamed through the slot's rings in batches of up to
+   * the ring capacity; results come back in submission order. The
+   * queries' `generation` fields are filled in here.
+   *
+   * @return False if no slot is claimed.
+   */
+  inline bool run(std::span<const pool_query_t> queries, std::vector<pool_result_t>& results) {
+    if (m_slot < 0) return false;
+    const auto* header = reinterpret_cast<const pool_segment_header_t*>(m_base);
+    auto* req = reinterpret_cast<pool_ring<pool_query_t>*>(slot_base());
+    auto* res = result_ring();
+
+    results.resize(queries.size());
+    std::vector<pool_query_t> batch;
+    size_t sent = 0, received = 0;
+    detail::idle_backoff idle;
+    while (received < queries.size()) {
+      // Keep at most one ring of queries in flight so results always fit
+      const size_t in_flight = sent - received;
+      const size_t room = size_t(header->ring_capacity) - in_flight;
+      if (sent < queries.size() && room > 0) {
+        batch.assign(queries.begin() + sent, queries.begin() + sent + std::min(room, queries.size() - sent));
+        for (auto& q : batch) q.generation = m_generation;
+        sent += req->push(batch);
+      }
+
+      // Drop late answers to a previous owner's queries
+      const size_t popped = res->pop(std::span<pool_result_t>(results.data() + received, queries.size() - received));
+      size_t n = 0;
+      for (size_t i = 0; i < popped; ++i) {
+        if (results[received + i].generation == m_generation)
+          results[received + n++] = results[received + i];
+      }
+      received += n;
+      if (popped == 0)
+        idle.wait();
+      else
+        idle.reset();
+    }
+    return true;
+  }
+
+private:
+  inline char* slot_base() const {
+    const auto* header = reinterpret_cast<const pool_segment_header_t*>(m_base);
+    return m_base + header->rings_offset + m_slot * detail::slot_bytes(header->ring_capacity);
+  }
+
+  inline pool_ring<pool_result_t>* result_ring() const {
+    const auto* header = reinterpret_cast<const pool_segment_header_t*>(m_base);
+    return reinterpret_cast<pool_ring<pool_result_t>*>(slot_base() + pool_ring<pool_query_t>::bytes(header->ring_capacity));
+  }
+
+  char*                        m_base       = nullptr;
+  size_t                       m_bytes      = 0;
+  std::span<const node_t<int>> m_nodes;
+  int                          m_slot       = -1;
+  uint32_t                     m_generation = 0;
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_SERVER_HPP
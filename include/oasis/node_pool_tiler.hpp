@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+#pragma once
+#ifndef NODE_POOL_TILER_HPP
+#define NODE_POOL_TILER_HPP
+
+#include <oasis/node_pool.hpp>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @brief Reads a pool file (node count followed by raw nodes).
+ * @return False if the file is missing or truncated.
+ */
+inline bool read_pool_file(const std::string& filename, std::vector<node_t<int>>& nodes) {
+  std::ifstream in(filename, std::ios::binary);
+  size_t count = 0;
+  if (!in.read(reinterpret_cast<char*>(&count), sizeof(count)))
+    return false;
+  nodes.resize(count);
+  return bool(in.read(reinterpret_cast<char*>(nodes.data()), count * sizeof(node_t<int>)));
+}
+
+/**
+ * @brief Writes a pool file in the format `node_pool::deserialize` reads.
+ */
+inline bool write_pool_file(const std::string& filename, std::span<const node_t<int>> nodes) {
+  std::ofstream out(filename, std::ios::binary);
+  const size_t count = nodes.size();
+  out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  out.write(reinterpret_cast<const char*>(nodes.data()), count * sizeof(node_t<int>));
+  return bool(out);
+}
+
+/**
+ * @class node_pool_tiler
+ * @brief Splits a build into octree tiles and assembles the tile pools.
+ *
+ * At tile level `L` the build region is cut into 2^L x 2^L x 2^L tiles.
+ * Each tile is built independently (typically by `node_pool_builder::build`
+ * at depth `depth - L` over the tile's box, possibly in another process)
+ * and `assemble` stitches the tiles under L new top levels, deduplicating
+ * nodes across all tiles in the same pass.
+ */
+class node_pool_tiler : public virtual node_pool {
+public:
+  /// Loads the pool of one tile; returns false if it is unavailable.
+  using tile_fetch_t = std::function<bool(glm::uvec3 tile, std::vector<node_t<int>>& nodes)>;
+
+  /// Default constructor.
+  explicit node_pool_tiler() = default;
+
+  /**
+   * @brief Minimum corner of a tile.
+   * @param corner Minimum corner of the whole build region.
+   * @param size Edge length of the whole build region.
+   * @param level Tile level.
+   * @param tile Tile coordinate, each axis in [0, 2^level).
+   */
+  static inline glm::vec3 tile_corner(glm::vec3 corner, float size, uint32_t level, glm::uvec3 tile) {
+    return corner + glm::vec3(tile) * tile_size(size, level);
+  }
+
+  /// Edge length of a tile.
+  static inline float tile_size(float size, uint32_t level) {
+    return size / float(1u << level);
+  }
+
+  /**
+   * @brief Assembles tile pools into this pool with a global dedup pass.
+   *
+   * Tiles are fetched one at a time in octree order, so only the tile
+   * being merged and the deduplicated result are in memory.
+   *
+   * @param level Tile level the tiles were built at.
+   * @param fetch Loads the pool of a tile (root at index 0).
+   * @return False if a tile could not be fetched.
+   */
+  inline bool assemble(uint32_t level, const tile_fetch_t& fetch) {
+    m_nodes.clear();
+    m_dedup.clear();
+    m_level = level;
+
+    bool ok = true;
+    const int root = recursive_assemble(0, glm::uvec3(0), fetch, ok);
+    if (root > 0)
+      detail::finalize_children_first(m_nodes, root - 1);
+    else
+      m_nodes.clear();
+    m_dedup.clear();
+    return ok;
+  }
+
+private:
+  /// Inserts a node, reusing an identical one; returns its child value.
+  inline int insert(const node_t<int>& node) {
+    auto [it, inserted] = m_dedup.try_emplace(node, int(m_nodes.size()));
+    if (inserted)
+      m_nodes.push_back(node);
+    return it->second + 1;
+  }
+
+  inline int recursive_assemble(uint32_t d, glm::uvec3 tile, const tile_fetch_t& fetch, bool& ok) {
+    if (d == m_level) {
+      std::vector<node_t<int>> nodes;
+      if (!fetch(tile, nodes)) {
+        ok = false;
+        return 0;
+      }
+      if (nodes.empty() || !nodes[0].has_value())
+        return 0;
+
+      // Children have higher indices than their parents: remap bottom-up
+      std::vector<int> remap(nodes.size(), 0);
+      for (size_t i = nodes.size(); i-- > 0;) {
+        node_t<int> node = nodes[i];
+        for (auto& child : node.children) {
+          if (child > 0)
+            child = remap[child - 1];
+        }
+        remap[i] = insert(node);
+      }
+      return remap[0];
+    }
+
+    node_t<int> node;
+    for (uint32_t i = 0; i < 8; ++i) {
+      const glm::uvec3 child_tile = tile * 2u + glm::uvec3(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+      node.children[i] = recursive_assemble(d + 1, child_tile, fetch, ok);
+    }
+    return node.has_value() ? insert(node) : 0;
+  }
+
+  uint32_t                             m_level = 0;
+  std::unordered_map<node_t<int>, int> m_dedup; ///< Node -> index in m_nodes.
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_TILER_HPP
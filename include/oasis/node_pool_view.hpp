@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_VIEW_HPP
+#define NODE_POOL_VIEW_HPP
+
+#include <oasis/node_pool.hpp>
+#include <array>
+#include <span>
+#include <stdexcept> // std::out_of_range
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Bounds checks in node_pool_view: on in debug builds, off with NDEBUG.
+#ifndef OASIS_VIEW_CHECKS
+#ifdef NDEBUG
+#define OASIS_VIEW_CHECKS 0
+#else
+#define OASIS_VIEW_CHECKS 1
+#endif
+#endif
+
+namespace oasis {
+
+/**
+ * @class node_pool_view
+ * @brief Read-only, trivially copyable view of a node array with inline access.
+ *
+ * `node_pool::get_node` and `get_nodes` are exported from the library and
+ * cannot be inlined, and `node_t::value(size_t)` checks every access. A
+ * view takes the node array once and then reads nodes and children with
+ * plain inline loads (checked only when `OASIS_VIEW_CHECKS` is set, the
+ * default in debug builds), so traversal loops can be inlined and
+ * vectorized. `lookup<Depth>` descends with the levels unrolled at
+ * compile time.
+ *
+ * Of the queries, only `query_point` descends through the view (via
+ * `lookup`). The others (`query_box`, `query_ray`, `detail::fixed_walk`,
+ * the beam, visibility and line-of-sight passes) take a `std::span`,
+ * whose loads are already inline and unchecked. The view converts to
+ * one, so it can be passed to them, but they do not use its checks or
+ * the unrolled descent.
+ *
+ * @tparam T Child type of the nodes.
+ * @tparam MaxDepth Deepest pool the runtime-depth `lookup` dispatches for.
+ */
+template <typename T = int, uint32_t MaxDepth = 30>
+class node_pool_view {
+public:
+  static_assert(MaxDepth >= 1 && MaxDepth <= 31, "MaxDepth must be in [1, 31]");
+
+  constexpr node_pool_view() = default;
+
+  constexpr node_pool_view(const node_t<T>* nodes, size_t count) : m_nodes(nodes), m_count(count) {}
+
+  constexpr node_pool_view(std::span<const node_t<T>> nodes) : m_nodes(nodes.data()), m_count(nodes.size()) {}
+
+  constexpr node_pool_view(const std::vector<node_t<T>>& nodes) : m_nodes(nodes.data()), m_count(nodes.size()) {}
+
+  /// Views a pool's nodes (one call into the library).
+  inline explicit node_pool_view(node_pool& pool) : node_pool_view(pool.get_nodes()) {}
+
+  constexpr operator std::span<const node_t<T>>() const { return {m_nodes, m_count}; }
+
+  constexpr size_t size() const { return m_count; }
+
+  constexpr bool empty() const { return m_count == 0; }
+
+  constexpr const node_t<T>* data() const { return m_nodes; }
+
+  /// Node at `index`.
+  constexpr const node_t<T>& node(size_t index) const {
+#if OASIS_VIEW_CHECKS
+    if (index >= m_count) throw std::out_of_range("Node index is out of range");
+#endif
+    return m_nodes[index];
+  }
+
+  constexpr const node_t<T>& operator[](size_t index) const { return node(index); }
+
+  /// Child `slot` (0-7) of node `index`.
+  constexpr T child(size_t index, uint32_t slot) const {
+#if OASIS_VIEW_CHECKS
+    if (slot >= 8) throw std::out_of_range("Child slot is out of range");
+#endif
+    return node(index).children[slot];
+  }
+
+  /// Child slot of voxel `v` below a node whose children are `1 << shift` voxels wide.
+  static constexpr uint32_t slot_of(glm::uvec3 v, uint32_t shift) {
+    return ((v.x >> shift) & 1) | (((v.y >> shift) & 1) << 1) | (((v.z >> shift) & 1) << 2);
+  }
+
+  /**
+   * @brief Value of a voxel of a pool built at `Depth`, with the descent unrolled.
+   *
+   * Same encoding as `query_point`: root at index 0, child 0 empty,
+   * negative a leaf, positive node index + 1.
+   *
+   * @param v Voxel coordinate, each axis in [0, 2^Depth).
+   * @return The leaf value, or 0 if the voxel is empty.
+   */
+  template <uint32_t Depth>
+  constexpr T lookup(glm::uvec3 v) const {
+    static_assert(Depth >= 1 && Depth <= MaxDepth, "Depth must be in [1, MaxDepth]");
+    if (empty()) return T(0);
+    size_t index = 0;
+    T value = T(0);
+    // One step per level, root first; stops at the first leaf or empty child
+    [&]<uint32_t... L>(std::integer_sequence<uint32_t, L...>) {
+      (void)(((value = child(index, slot_of(v, Depth - 1 - L))) > T(0) && (index = size_t(value - 1), true)) && ...);
+    }(std::make_integer_sequence<uint32_t, Depth>{});
+    return value > T(0) ? T(0) : value;
+  }
+
+  /// `lookup<Depth>` for a depth known only at run time (0 if it exceeds `MaxDepth`).
+  inline T lookup(glm::uvec3 v, uint32_t depth) const {
+    using lookup_fn = T (node_pool_view::*)(glm::uvec3) const;
+    static constexpr auto table = []<uint32_t... D>(std::integer_sequence<uint32_t, D...>) {
+      return std::array<lookup_fn, MaxDepth>{&node_pool_view::lookup<D + 1>...};
+    }(std::make_integer_sequence<uint32_t, MaxDepth>{});
+    if (depth == 0 || depth > MaxDepth) return T(0);
+    return (this->*table[depth - 1])(v);
+  }
+
+private:
+  const node_t<T>* m_nodes = nullptr;
+  size_t           m_count = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<node_pool_view<>>);
+
+} // namespace oasis
+
+#endif // NODE_POOL_VIEW_HPP
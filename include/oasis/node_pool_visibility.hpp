@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_VISIBILITY_HPP
+#define NODE_POOL_VISIBILITY_HPP
+
+#include <oasis/node_pool_beam.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @struct frustum_t
+ * @brief Six inward-facing planes (n.x, n.y, n.z, d): inside where dot(n, p) + d >= 0.
+ */
+struct frustum_t {
+  glm::vec4 planes[6];
+
+  /// Frustum of a camera between the near and far distances.
+  static inline frustum_t from_camera(const camera_t& camera, float near_dist, float far_dist) {
+    const glm::vec3 f = glm::normalize(camera.forward);
+    const glm::vec3 r = glm::normalize(glm::cross(f, camera.up));
+    const glm::vec3 u = glm::cross(r, f);
+    const float h = std::tan(camera.fov_y * 0.5f);
+    const float w = h * float(camera.width) / float(camera.height);
+
+    auto plane = [&](glm::vec3 n, glm::vec3 p) {
+      n = glm::normalize(n);
+      return glm::vec4(n.x, n.y, n.z, -glm::dot(n, p));
+    };
+    frustum_t out;
+    out.planes[0] = plane(f, camera.eye + f * near_dist);
+    out.planes[1] = plane(-f, camera.eye + f * far_dist);
+    out.planes[2] = plane(glm::cross(u, f + r * w), camera.eye);  // right
+    out.planes[3] = plane(glm::cross(f - r * w, u), camera.eye);  // left
+    out.planes[4] = plane(glm::cross(f + u * h, r), camera.eye);  // top
+    out.planes[5] = plane(glm::cross(r, f - u * h), camera.eye);  // bottom
+    return out;
+  }
+
+  /// True if the box is entirely inside every plane.
+  inline bool contains(glm::vec3 min, glm::vec3 max) const {
+    for (const auto& p : planes) {
+      const glm::vec3 v(p.x >= 0 ? min.x : max.x, p.y >= 0 ? min.y : max.y, p.z >= 0 ? min.z : max.z);
+      if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0)
+        return false;
+    }
+    return true;
+  }
+
+  /// False only if the box is entirely outside one plane.
+  inline bool overlaps(glm::vec3 min, glm::vec3 max) const {
+    for (const auto& p : planes) {
+      const glm::vec3 v(p.x >= 0 ? max.x : min.x, p.y >= 0 ? max.y : min.y, p.z >= 0 ? max.z : min.z);
+      if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0)
+        return false;
+    }
+    return true;
+  }
+};
+
+/**
+ * @brief Collects the nodes a camera needs, down to a screen-space error.
+ *
+ * Cells are culled against the frustum level by level. A node is needed
+ * if its cell is visible; its children are needed only while the cell
+ * projects to more than `pixel_error` pixels. Shared nodes are reported
+ * once, at the coarsest level they are first needed, so the output can
+ * be streamed in order and every node arrives after a parent referencing it.
+ * Each level's frontier is split across threads. A shared node whose
+ * whole subtree is needed (inside the frustum and refined to the leaves)
+ * is expanded at its first such occurrence only.
+ *
+ * @param pixel_error Largest projected cell size (pixels) that is not refined.
+ * @param threads Worker threads (0 = hardware concurrency).
+ * @return Unique node indices ordered coarse to fine (ascending within a level).
+ */
+inline std::vector<uint32_t> visible_nodes(std::span<const node_t<int>> nodes, const pool_frame_t& frame,
+                                           const camera_t& camera, float pixel_error = 1.0f,
+                                           uint32_t threads = 0) {
+  std::vector<uint32_t> out;
+  const frustum_t frustum = frustum_t::from_camera(camera, 0.0f, 1e30f);
+  if (nodes.empty() || !frustum.overlaps(frame.corner, frame.corner + frame.size))
+    return out;
+
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  // Pixels per world unit at distance 1
+  const float pixels = float(camera.height) / (2.0f * std::tan(camera.fov_y * 0.5f));
+
+  const float voxel = frame.size / float(1u << frame.depth);
+
+  std::vector<std::atomic<uint64_t>> seen((nodes.size() + 63) / 64), full((nodes.size() + 63) / 64);
+  auto claim = [](std::vector<std::atomic<uint64_t>>& bits, uint32_t node) {
+    const uint64_t bit = uint64_t(1) << (node & 63);
+    return !(bits[node >> 6].fetch_or(bit, std::memory_order_relaxed) & bit);
+  };
+  auto first_visit = [&](uint32_t node) { return claim(seen, node); };
+
+  struct cell_t { uint32_t node; glm::vec3 corner; float size; };
+  std::vector<cell_t> frontier{{0, frame.corner, frame.size}};
+  first_visit(0);
+  out.push_back(0);
+
+  for (uint32_t level = 0; level + 1 < frame.depth && !frontier.empty(); ++level) {
+    const size_t count = std::min<size_t>(threads, (frontier.size() + 255) / 256);
+    std::vector<std::vector<cell_t>> next(count);
+    std::vector<std::vector<uint32_t>> found(count);
+
+    auto work = [&](size_t part) {
+      const size_t begin = frontier.size() * part / count, end = frontier.size() * (part + 1) / count;
+      for (size_t k = begin; k < end; ++k) {
+        const cell_t& c = frontier[k];
+        // Refine only cells that still look bigger than the error
+        const glm::vec3 q = glm::clamp(camera.eye, c.corner, c.corner + c.size);
+        const float dist = glm::length(q - camera.eye);
+        if (dist > 0.0f && c.size * pixels / dist <= pixel_error)
+          continue;
+        const float h = c.size * 0.5f;
+        for (uint32_t i = 0; i < 8; ++i) {
+          const int child = nodes[c.node].children[i];
+          if (child <= 0) continue;
+          const glm::vec3 corner = c.corner + child_offset(i) * h;
+          if (!frustum.overlaps(corner, corner + h)) continue;
+          const uint32_t index = uint32_t(child - 1);
+          if (first_visit(index))
+            found[part].push_back(index);
+
+          // Whole subtree needed: cells 4 voxels wide still refine at the far corner
+          const glm::vec3 far = glm::max(glm::abs(corner - camera.eye), glm::abs(corner + h - camera.eye));
+          if (frustum.contains(corner, corner + h) && 4.0f * voxel * pixels / glm::length(far) > pixel_error &&
+              !claim(full, index))
+            continue;
+          next[part].push_back({index, corner, h});
+        }
+      }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t part = 1; part < count; ++part)
+      pool.emplace_back(work, part);
+    work(0);
+    for (auto& th : pool) th.join();
+
+    const size_t first = out.size();
+    frontier.clear();
+    for (size_t part = 0; part < count; ++part) {
+      out.insert(out.end(), found[part].begin(), found[part].end());
+      frontier.insert(frontier.end(), next[part].begin(), next[part].end());
+    }
+    std::sort(out.begin() + first, out.end());
+  }
+  return out;
+}
+
+} // namespace oasis
+
+#endif // NODE_POOL_VISIBILITY_HPP
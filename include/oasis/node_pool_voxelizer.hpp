@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+#pragma once
+#ifndef NODE_POOL_VOXELIZER_HPP
+#define NODE_POOL_VOXELIZER_HPP
+
+#include <oasis/node_pool.hpp>
+#include <oasis/scene.hpp>
+#include <oasis/texture_cache.hpp>
+#include <oasis/voxel_attributes.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @enum voxelization_mode_t
+ * @brief Which voxels a triangle claims at the finest level.
+ */
+enum class voxelization_mode_t {
+  conservative,  ///< Every voxel the triangle touches (what `node_pool_builder::build` produces).
+  separating_26, ///< Plane overlaps the voxel and every 2D projection covers its diamond (no 26-connected tunnels).
+  separating_6   ///< Plane within the voxel's inner slab along the dominant axis (thinnest, no 6-connected tunnels).
+};
+
+/**
+ * @struct voxelization_stats_t
+ * @brief Summary of one voxelization run.
+ */
+struct voxelization_stats_t {
+  voxelization_mode_t mode     = voxelization_mode_t::conservative;
+  size_t              nodes    = 0; ///< Unique nodes in the pool.
+  size_t              voxels   = 0; ///< Leaf voxels set (counted before deduplication).
+  double              build_ms = 0; ///< Wall time of the build.
+};
+
+/**
+ * @struct tri_setup_t
+ * @brief Per-triangle plane and edge functions for fast box tests.
+ *
+ * Precomputed once; a test against a box of any half-size `h` is then
+ * a handful of multiply-adds (Schwarz & Seidel style).
+ */
+struct tri_setup_t {
+  glm::vec3 bmin, bmax;       ///< Triangle bounds.
+  glm::vec3 n;                ///< Unnormalized plane normal.
+  float     d;                ///< Plane offset, n . v0.
+  int       dominant;         ///< Axis of the largest normal component.
+  glm::vec2 en[3][3];         ///< Edge normals per projection (yz, zx, xy).
+  float     ed[3][3];         ///< Edge offsets per projection, -en . v.
+
+  inline explicit tri_setup_t(const glm::vec3 v[3]) {
+    bmin = glm::min(glm::min(v[0], v[1]), v[2]);
+    bmax = glm::max(glm::max(v[0], v[1]), v[2]);
+    n = glm::cross(v[1] - v[0], v[2] - v[0]);
+    d = glm::dot(n, v[0]);
+    const glm::vec3 an = glm::abs(n);
+    dominant = an.x >= an.y ? (an.x >= an.z ? 0 : 2) : (an.y >= an.z ? 1 : 2);
+
+    for (int axis = 0; axis < 3; ++axis) {
+      const int a = (axis + 1) % 3, b = (axis + 2) % 3;
+      const float s = n[axis] >= 0.0f ? 1.0f : -1.0f;
+      for (int i = 0; i < 3; ++i) {
+        const glm::vec3& p = v[i];
+        const glm::vec3& q = v[(i + 1) % 3];
+        en[axis][i] = glm::vec2(-(q[b] - p[b]), q[a] - p[a]) * s;
+        ed[axis][i] = -glm::dot(en[axis][i], glm::vec2(p[a], p[b]));
+      }
+    }
+  }
+
+  /// Box of center `c` and half-size `h` overlaps the triangle's bounds.
+  inline bool bounds_overlap(const glm::vec3& c, float h) const {
+    return c.x + h >= bmin.x && c.x - h <= bmax.x &&
+           c.y + h >= bmin.y && c.y - h <= bmax.y &&
+           c.z + h >= bmin.z && c.z - h <= bmax.z;
+  }
+
+  /// Edge functions of one projection; `diamond` shrinks the box to its inscribed diamond.
+  inline bool projection_overlap(int axis, const glm::vec3& c, float h, bool diamond) const {
+    const int a = (axis + 1) % 3, b = (axis + 2) % 3;
+    const glm::vec2 p(c[a], c[b]);
+    for (int i = 0; i < 3; ++i) {
+      const glm::vec2 e = glm::abs(en[axis][i]);
+      const float support = h * (diamond ? std::max(e.x, e.y) : e.x + e.y);
+      if (glm::dot(en[axis][i], p) + ed[axis][i] + support < 0.0f)
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Tests the triangle against a cubic voxel.
+   * @param c Voxel center.
+   * @param h Voxel half-size.
+   * @param mode Which voxelization the test implements.
+   */
+  inline bool overlaps(const glm::vec3& c, float h, voxelization_mode_t mode) const {
+    if (!bounds_overlap(c, h))
+      return false;
+
+    const glm::vec3 an = glm::abs(n);
+    const float dist = std::abs(glm::dot(n, c) - d);
+    switch (mode) {
+    case voxelization_mode_t::conservative:
+      return dist <= h * (an.x + an.y + an.z) &&
+             projection_overlap(0, c, h, false) &&
+             projection_overlap(1, c, h, false) &&
+             projection_overlap(2, c, h, false);
+    case voxelization_mode_t::separating_26:
+      return dist <= h * (an.x + an.y + an.z) &&
+             projection_overlap(0, c, h, true) &&
+             projection_overlap(1, c, h, true) &&
+             projection_overlap(2, c, h, true);
+    case voxelization_mode_t::separating_6:
+      return dist <= h * an[dominant] &&
+             projection_overlap(dominant, c, h, true);
+    }
+    return false;
+  }
+};
+
+/**
+ * @class node_pool_voxelizer
+ * @brief Builds a node pool from a scene with a selectable voxelization mode.
+ *
+ * Produces the same layout as `node_pool_builder::build` (root at index 0,
+ * children stored as index + 1, leaves as negated RGB8), so pools from
+ * either builder are interchangeable. Coarse levels are always culled
+ * with the conservative test; `mode` only decides which finest-level
+ * voxels are set.
+ *
+ * Textures are sampled from `scene::m_textures` unless a `texture_cache`
+ * (`use_texture_cache`, the scene then needs no textures loaded at all)
+ * or a `texture_atlas` (`use_texture_atlas`, the scene's images can be
+ * released once packed) is attached.
+ */
+class node_pool_voxelizer : public virtual node_pool {
+public:
+  /// Default constructor.
+  explicit node_pool_voxelizer() = default;
+
+  /**
+   * @brief Samples material textures from a cache instead of the scene.
+   *
+   * Texture names are looked up in the cache by material texture name,
+   * as `texture_cache::add_materials` registers them.
+   *
+   * @param cache The cache (owned by the caller), or null to sample the scene again.
+   */
+  inline void use_texture_cache(texture_cache* cache) {
+    m_texture_cache = cache;
+    m_atlas = nullptr;
+  }
+
+  /**
+   * @brief Samples material textures from an atlas instead of the scene.
+   * @param atlas The atlas (owned by the caller), or null to sample the scene again.
+   */
+  inline void use_texture_atlas(const texture_atlas* atlas) {
+    m_atlas = atlas;
+    m_texture_cache = nullptr;
+  }
+
+  /**
+   * @brief Voxelizes a scene into this pool.
+   *
+   * @param p_scene Pointer to the scene containing geometry data.
+   * @param depth Maximum depth of the octree (the grid is 2^depth voxels wide).
+   * @param corner The minimum corner of the bounding region.
+   * @param size The length of the bounding region's edge.
+   * @param mode Voxelization mode for the finest level.
+   * @param attributes If set, receives each voxel's normal and material in leaf order.
+   * @return Node count, voxel count and build time.
+   */
+  inline voxelization_stats_t voxelize(scene* p_scene, int depth, glm::vec3 corner, float size,
+                                       voxelization_mode_t mode = voxelization_mode_t::conservative,
+                                       voxel_attributes* attributes = nullptr) {
+    auto start = std::chrono::high_resolution_clock::now();
+    voxelization_stats_t stats;
+    stats.mode = mode;
+
+    m_nodes.clear();
+    m_scene = p_scene;
+    m_mode = mode;
+    m_depth = depth;
+    m_voxels = 0;
+    m_dedup.clear();
+    m_collect_attributes = attributes != nullptr;
+    m_attributes.clear();
+
+    setup_triangles();
+    setup_materials();
+
+    std::vector<uint32_t> indexes(m_tris.size());
+    for (uint32_t i = 0; i < indexes.size(); ++i)
+      indexes[i] = i;
+
+    const int root = recursive_voxelize(0, corner, size, indexes);
+    if (root > 0)
+      detail::finalize_children_first(m_nodes, root - 1);
+    else
+      m_nodes.clear();
+
+    m_tris.clear();
+    m_dedup.clear();
+
+    if (attributes) {
+      attributes->build(m_nodes, m_attributes);
+      m_attributes = {};
+    }
+
+    stats.nodes = m_nodes.size();
+    stats.voxels = m_voxels;
+    stats.build_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::high_resolution_clock::now() - start).count();
+    return stats;
+  }
+
+protected:
+  /// Fills `v` with the corners of triangle `id` (indexed or raw geometry).
+  inline void triangle_vertices(size_t id, glm::vec3 v[3]) const {
+    if (!m_scene->m_indexed_tris.empty()) {
+      m_scene->get_triangle_vertices(id, v[0], v[1], v[2]);
+    } else {
+      const glm::vec3* t = m_scene->get_triangle_ptr(id);
+      v[0] = t[0]; v[1] = t[1]; v[2] = t[2];
+    }
+  }
+
+  inline void setup_triangles() {
+    m_tris.clear();
+    const size_t count = m_scene->m_indexed_tris.empty() ? m_scene->get_raw_triangles_count()
+                                                          : m_scene->m_indexed_tris.size();
+    m_tris.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      glm::vec3 v[3];
+      triangle_vertices(i, v);
+      m_tris.emplace_back(v);
+    }
+  }
+
+  inline void setup_materials() {
+    const auto& materials = m_scene->m_materials;
+    m_textured.assign(materials.size(), 0);
+    m_texture_ids.assign(materials.size(), 0);
+    const std::vector<int32_t> regions = m_atlas ? m_atlas->bind_materials(materials) : std::vector<int32_t>();
+    for (size_t i = 0; i < materials.size(); ++i) {
+      if (m_atlas) {
+        m_textured[i] = regions[i] >= 0;
+        m_texture_ids[i] = uint32_t(std::max(regions[i], 0));
+      } else if (m_texture_cache) {
+        const auto id = m_texture_cache->find(materials[i].texture);
+        m_textured[i] = id.has_value();
+        m_texture_ids[i] = id.value_or(0);
+      } else {
+        m_textured[i] = m_scene->m_textures.count(materials[i].texture) != 0;
+      }
+    }
+  }
+
+  /**
+   * @brief Color of triangle `id` at the point nearest to `p`, as a leaf value.
+   */
+  inline int leaf_value(size_t id, const glm::vec3& p) {
+    glm::vec3 c(0.5f);
+    if (!m_scene->m_indexed_tris.empty()) {
+      const size_t material = m_scene->get_triangle_material_id(id);
+      if (material < m_scene->m_materials.size())
+        m_scene->get_triangle_color(id, c);
+
+      if (material < m_textured.size() && m_textured[material] && m_scene->is_triangle_textured(id)) {
+        glm::vec3 v[3];
+        triangle_vertices(id, v);
+        const glm::vec3 w = barycentric(v, p);
+        glm::vec2 t0, t1, t2;
+        m_scene->get_triangle_tex_coords(id, t0, t1, t2);
+        glm::vec2 uv = t0 * w.x + t1 * w.y + t2 * w.z;
+        uv = uv - glm::floor(uv); // wrap
+        if (m_atlas)
+          c = m_atlas->sample(m_texture_ids[material], uv);
+        else if (!m_texture_cache)
+          m_scene->get_tex_color(m_scene->m_materials[material].texture, uv, c);
+        else if (auto texel = m_texture_cache->fetch(m_texture_ids[material], uv))
+          c = unpack_rgb8(*texel);
+      }
+    }
+    return encode_leaf(c);
+  }
+
+  /**
+   * @brief Interpolated normal and material of triangle `id` near `p`.
+   */
+  inline voxel_attribute_t attribute_value(size_t id, const glm::vec3& p) {
+    glm::vec3 v[3];
+    triangle_vertices(id, v);
+    glm::vec3 n = glm::cross(v[1] - v[0], v[2] - v[0]);
+
+    voxel_attribute_t a;
+    if (!m_scene->m_indexed_tris.empty()) {
+      const auto& tri = m_scene->m_indexed_tris[id];
+      if (std::max({tri.normals_idx[0], tri.normals_idx[1], tri.normals_idx[2]}) < m_scene->m_normals.size()) {
+        const glm::vec3 w = barycentric(v, p);
+        glm::vec3 n0, n1, n2;
+        m_scene->get_triangle_normals(id, n0, n1, n2);
+        const glm::vec3 interpolated = n0 * w.x + n1 * w.y + n2 * w.z;
+        if (glm::dot(interpolated, interpolated) > 0.0f)
+          n = interpolated;
+      }
+      a.material = uint32_t(m_scene->get_triangle_material_id(id));
+    }
+    a.normal = encode_oct16(n);
+    return a;
+  }
+
+  /// Encodes a color as a leaf child value (never 0, which means empty).
+  static inline int encode_leaf(const glm::vec3& c) {
+    const glm::ivec3 q = glm::ivec3(glm::clamp(c, glm::vec3(0.0f), glm::vec3(1.0f)) * 255.0f);
+    const int rgb = (q.x << 16) | (q.y << 8) | q.z;
+    return -std::max(rgb, 1);
+  }
+
+  /// Clamped barycentric weights of `p` projected onto the triangle's plane.
+  static inline glm::vec3 barycentric(const glm::vec3 v[3], const glm::vec3& p) {
+    const glm::vec3 e0 = v[1] - v[0], e1 = v[2] - v[0], ep = p - v[0];
+    const float d00 = glm::dot(e0, e0), d01 = glm::dot(e0, e1), d11 = glm::dot(e1, e1);
+    const float d20 = glm::dot(ep, e0), d21 = glm::dot(ep, e1);
+    const float denom = d00 * d11 - d01 * d01;
+    if (std::abs(denom) < 1e-20f)
+      return glm::vec3(1.0f, 0.0f, 0.0f);
+    glm::vec3 w;
+    w.y = (d11 * d20 - d01 * d21) / denom;
+    w.z = (d00 * d21 - d01 * d20) / denom;
+    w.x = 1.0f - w.y - w.z;
+    w = glm::max(w, glm::vec3(0.0f));
+    return w / (w.x + w.y + w.z);
+  }
+
+  /**
+   * @brief Builds the subtree of one cell.
+   * @return The child value for the cell: 0 (empty), a leaf, or node index + 1.
+   */
+  inline int recursive_voxelize(int d, glm::vec3 min, float size, const std::vector<uint32_t>& indexes) {
+    const float h = size * 0.5f;
+    const glm::vec3 c = min + glm::vec3(h);
+
+    if (d == m_depth) {
+      for (uint32_t id : indexes) {
+        if (m_tris[id].overlaps(c, h, m_mode)) {
+          ++m_voxels;
+          if (m_collect_attributes)
+            m_attributes.push_back(attribute_value(id, c));
+          return leaf_value(id, c);
+        }
+      }
+      return 0;
+    }
+
+    node_t<int> node;
+    std::vector<uint32_t> child_indexes;
+    child_indexes.reserve(indexes.size());
+    const float ch = h * 0.5f;
+    for (uint32_t i = 0; i < 8; ++i) {
+      const glm::vec3 cmin = min + glm::vec3(float(i & 1), float((i >> 1) & 1), float((i >> 2) & 1)) * h;
+      const glm::vec3 cc = cmin + glm::vec3(ch);
+
+      child_indexes.clear();
+      for (uint32_t id : indexes) {
+        if (m_tris[id].overlaps(cc, ch, voxelization_mode_t::conservative))
+          child_indexes.push_back(id);
+      }
+      if (!child_indexes.empty())
+        node.children[i] = recursive_voxelize(d + 1, cmin, h, child_indexes);
+    }
+
+    if (!node.has_value())
+      return 0;
+
+    auto [it, inserted] = m_dedup.try_emplace(node, int(m_nodes.size()));
+    if (inserted)
+      m_nodes.push_back(node);
+    return it->second + 1;
+  }
+
+protected:
+  scene*                                m_scene = nullptr;
+  voxelization_mode_t                   m_mode  = voxelization_mode_t::conservative;
+  int                                   m_depth = 0;
+  size_t                                m_voxels = 0;
+  std::vector<tri_setup_t>              m_tris;     ///< Per-triangle test setup.
+  std::vector<char>                     m_textured; ///< Per-material: texture is loaded.
+  texture_cache*                        m_texture_cache = nullptr; ///< Texture source instead of the scene, if set.
+  const texture_atlas*                  m_atlas = nullptr;         ///< Texture source instead of the scene, if set.
+  std::vector<uint32_t>                 m_texture_ids;  ///< Per-material texture id in m_texture_cache, or region in m_atlas.
+  std::unordered_map<node_t<int>, int>  m_dedup;    ///< Node -> index in m_nodes.
+  bool                                  m_collect_attributes = false;
+  std::vector<voxel_attribute_t>        m_attributes; ///< Per-voxel attributes in leaf order.
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_VOXELIZER_HPP
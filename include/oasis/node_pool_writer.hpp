@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NODE_POOL_WRITER_HPP
+#define NODE_POOL_WRITER_HPP
+
+#include <oasis/node_pool.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace oasis {
+
+/**
+ * @struct pool_write_options_t
+ * @brief How `node_pool_writer` writes files.
+ */
+struct pool_write_options_t {
+  size_t chunk_bytes = size_t(8) << 20; ///< Bytes per write call (rounded to the alignment).
+  size_t alignment   = 4096;            ///< Buffer, offset and size alignment of each chunk.
+  bool   direct      = false;           ///< Open with O_DIRECT where supported (falls back if refused).
+  bool   sync        = false;           ///< fsync before completing.
+};
+
+/**
+ * @struct pool_write_result_t
+ * @brief Outcome of one asynchronous write.
+ */
+struct pool_write_result_t {
+  bool                     ok = false;
+  bool                     direct = false; ///< Whether O_DIRECT was actually used.
+  size_t                   bytes = 0;      ///< File size written.
+  double                   ms = 0;         ///< Time from the first to the last write call.
+  std::vector<node_t<int>> nodes;          ///< The submitted nodes, handed back for reuse.
+
+  /// Throughput of this write in MB/s.
+  inline double mb_per_s() const { return ms > 0 ? bytes / 1e3 / ms : 0.0; }
+};
+
+/**
+ * @class node_pool_writer
+ * @brief Writes pool files from a background thread (write-behind).
+ *
+ * `submit` takes ownership of a node vector and returns immediately; the
+ * file (node count followed by raw nodes, as `node_pool::deserialize`
+ * reads) is written in aligned chunks from one worker thread, in
+ * submission order. The future gives the result and the node vector
+ * back, so a builder can swap its nodes out, keep going, and recycle the
+ * buffer later. The destructor finishes all pending writes.
+ */
+class node_pool_writer {
+public:
+  inline explicit node_pool_writer(const pool_write_options_t& options = {}) : m_options(options) {
+    m_options.alignment = std::max<size_t>(m_options.alignment, alignof(size_t));
+    m_options.chunk_bytes = std::max(m_options.alignment, 
+      m_options.chunk_bytes / m_options.alignment * m_options.alignment);
+    m_thread = std::thread([this]() { run(); });
+  }
+
+  inline ~node_pool_writer() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+  }
+
+  node_pool_writer(const node_pool_writer&) = delete;
+  node_pool_writer& operator=(const node_pool_writer&) = delete;
+
+  /**
+   * @brief Queues a pool file for writing.
+   * @param filename Destination file (replaced if it exists).
+   * @param nodes The pool nodes; moved in and returned in the result.
+   * @return Completes once the file is written (or failed).
+   */
+  inline std::future<pool_write_result_t> submit(const std::string& filename, std::vector<node_t<int>> nodes) {
+    job_t job{filename, std::move(nodes), {}};
+    auto future = job.promise.get_future();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_jobs.push_back(std::move(job));
+    }
+    m_cv.notify_one();
+    return future;
+  }
+
+  /// Number of writes queued or in progress.
+  inline size_t pending() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobs.size() + (m_busy ? 1 : 0);
+  }
+
+  /// Sustained throughput in MB/s over every completed write.
+  inline double throughput() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_total_ms > 0 ? m_total_bytes / 1e3 / m_total_ms : 0.0;
+  }
+
+  /// Total bytes written so far.
+  inline size_t bytes_written() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_total_bytes;
+  }
+
+private:
+  struct job_t {
+    std::string                          filename;
+    std::vector<node_t<int>>             nodes;
+    std::promise<pool_write_result_t>    promise;
+  };
+
+  struct aligned_free_t {
+    void operator()(char* p) const { std::free(p); }
+  };
+
+  inline void run() {
+    // One chunk buffer for the writer's lifetime
+    std::unique_ptr<char, aligned_free_t> buffer(
+      static_cast<char*>(std::aligned_alloc(m_options.alignment, m_options.chunk_bytes)));
+
+    for (;;) {
+      job_t job;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [&] { return m_stop || !m_jobs.empty(); });
+        if (m_jobs.empty())
+          return;
+        job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_busy = true;
+      }
+
+      pool_write_result_t result = buffer ? write(job, buffer.get()) : pool_write_result_t{};
+      result.nodes = std::move(job.nodes);
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_busy = false;
+        if (result.ok) {
+          m_total_bytes += result.bytes;
+          m_total_ms += result.ms;
+        }
+      }
+      job.promise.set_value(std::move(result));
+    }
+  }
+
+  inline pool_write_result_t write(const job_t& job, char* buffer) const {
+    pool_write_result_t result;
+    const size_t count = job.nodes.size();
+    const size_t total = sizeof(count) + count * sizeof(node_t<int>);
+    const char* data = reinterpret_cast<const char*>(job.nodes.data());
+
+    int fd = -1;
+#ifdef O_DIRECT
+    if (m_options.direct) {
+      fd = ::open(job.filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+      result.direct = fd >= 0;
+    }
+#endif
+    if (fd < 0)
+      fd = ::open(job.filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+      return result;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool ok = true;
+    size_t offset = 0; // file offset of the chunk in `buffer`
+    while (ok && offset < total) {
+      // Fill the chunk: header first, then node bytes
+      const size_t n = std::min(m_options.chunk_bytes, total - offset);
+      for (size_t i = 0; i < n;) {
+        const size_t pos = offset + i;
+        if (pos < sizeof(count)) {
+          const size_t k = std::min(sizeof(count) - pos, n - i);
+          std::memcpy(buffer + i, reinterpret_cast<const char*>(&count) + pos, k);
+          i += k;
+        } else {
+          std::memcpy(buffer + i, data + (pos - sizeof(count)), n - i);
+          i = n;
+        }
+      }
+
+      // O_DIRECT needs whole aligned blocks; the tail is padded and truncated below
+      size_t len = n;
+      if (result.direct) {
+        len = (n + m_options.alignment - 1) / m_options.alignment * m_options.alignment;
+        std::memset(buffer + n, 0, len - n);
+      }
+      for (size_t done = 0; done < len;) {
+        const ssize_t w = ::pwrite(fd, buffer + done, len - done, off_t(offset + done));
+        if (w <= 0) {
+          ok = false;
+          break;
+        }
+        done += size_t(w);
+      }
+      offset += n;
+    }
+    if (ok && result.direct)
+      ok = ::ftruncate(fd, off_t(total)) == 0;
+    if (ok && m_options.sync)
+      ok = ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+
+    result.ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    result.ok = ok;
+    result.bytes = ok ? total : 0;
+    return result;
+  }
+
+  pool_write_options_t    m_options;
+  std::thread             m_thread;
+  mutable std::mutex      m_mutex;
+  std::condition_variable m_cv;
+  std::deque<job_t>       m_jobs;
+  bool                    m_stop = false;
+  bool                    m_busy = false;
+  size_t                  m_total_bytes = 0;
+  double                  m_total_ms = 0;
+};
+
+} // namespace oasis
+
+#endif // NODE_POOL_WRITER_HPP
@@ -31,6 +31,15 @@
 #include <vector>
 #include <span>
 #include <map>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <glm/glm.hpp>
 
 #include "CImg.h"
@@ -145,6 +154,15 @@ struct aabb_t {
   }
 };
 
+/**
+ * @struct scene_file_t
+ * @brief An input file of a multi-file scene together with its placement.
+ */
+struct scene_file_t {
+  std::string path;                        ///< Path to the model file.
+  glm::mat4   transform = glm::mat4(1.0f); ///< Local-to-scene transform applied on merge.
+};
+
 
 class scene {
 public:
@@ -163,6 +181,275 @@ public:
   // Load scene data from a file.
   bool load(const std::string& filepath);
 
+  /**
+   * @brief Loads several files in parallel and merges them into this scene.
+   *
+   * Each file is loaded (with its textures, resolved relative to the file) 
+   * on one of `threads` workers. Files are merged in list order as soon as 
+   * they are ready, so the result does not depend on scheduling and each 
+   * per-file scene is released right after it has been merged. An
+   * exception thrown while loading a file (e.g. by Assimp or CImg) fails
+   * that file only, as a failed `load` would.
+   *
+   * @param files The files to load, each with its own transform.
+   * @param threads Number of loader threads (0 = hardware concurrency).
+   * @param textures False to skip loading textures (material names are still resolved).
+   * @return False if any file failed to load.
+   */
+  inline bool load(std::span<const scene_file_t> files, size_t threads = 0, bool textures = true) {
+    if (files.empty()) 
+      return false;
+    if (threads == 0) 
+      threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    threads = std::min(threads, files.size());
+
+    std::vector<std::optional<scene>> loaded(files.size());
+    std::vector<char> ready(files.size(), 0);
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    auto worker = [&]() {
+      for (size_t i = next++; i < files.size(); i = next++) {
+        std::optional<scene> part(std::in_place);
+        try {
+          if (part->load(files[i].path)) {
+            if (textures) {
+              try {
+                part->load_textures(std::filesystem::path(files[i].path).parent_path().string());
+              } catch (const CImgException& e) {
+                printf("Failed to load textures of '%s': %s\n", files[i].path.c_str(), e.what());
+              }
+            }
+          } else {
+            part.reset();
+          }
+        } catch (const std::exception& e) {
+          printf("Exception while loading '%s': %s\n", files[i].path.c_str(), e.what());
+          part.reset();
+        } catch (...) {
+          printf("Exception while loading '%s'\n", files[i].path.c_str());
+          part.reset();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        loaded[i] = std::move(part);
+        ready[i] = 1;
+        cv.notify_all();
+      }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t) 
+      pool.emplace_back(worker);
+
+    bool ok = true;
+    for (size_t i = 0; i < files.size(); ++i) {
+      std::optional<scene> part;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return ready[i] != 0; });
+        part = std::move(loaded[i]);
+      }
+      if (!part) {
+        printf("Failed to load scene part '%s'\n", files[i].path.c_str());
+        ok = false;
+        continue;
+      }
+      merge(*part, files[i].transform, 
+            std::filesystem::path(files[i].path).parent_path().string());
+    }
+
+    for (auto& t : pool) 
+      t.join();
+    return ok;
+  }
+
+  /**
+   * @brief Loads every file listed in a manifest and merges them.
+   *
+   * One file per line: a path (relative to the manifest) optionally followed 
+   * by 3 numbers (translation), 4 numbers (translation and uniform scale) or 
+   * 12 numbers (row-major 3x4 affine transform). Blank lines and lines 
+   * starting with '#' are ignored.
+   *
+   * The path is the whole line up to the trailing numbers, so it may
+   * contain spaces. A path that itself ends in numbers, or has leading or
+   * trailing spaces, must be put in double quotes.
+   *
+   * @param manifest Path to the manifest file.
+   * @param threads Number of loader threads (0 = hardware concurrency).
+   * @param textures False to skip loading textures.
+   * @return False if the manifest could not be read or a file failed to load.
+   */
+  inline bool load_manifest(const std::string& manifest, size_t threads = 0, bool textures = true) {
+    std::ifstream in(manifest);
+    if (!in) 
+      return false;
+
+    const std::filesystem::path base = std::filesystem::path(manifest).parent_path();
+    std::vector<scene_file_t> files;
+    std::string line;
+    while (std::getline(in, line)) {
+      const size_t first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos || line[first] == '#') 
+        continue;
+      line = line.substr(first, line.find_last_not_of(" \t\r") + 1 - first);
+
+      scene_file_t file;
+      std::vector<float> v;
+      if (line[0] == '"') {
+        const size_t close = line.find('"', 1);
+        if (close == std::string::npos) {
+          printf("Ignoring unterminated path in manifest: %s\n", line.c_str());
+          continue;
+        }
+        file.path = line.substr(1, close - 1);
+        std::istringstream ss(line.substr(close + 1));
+        for (float f; ss >> f;) 
+          v.push_back(f);
+      } else {
+        // Peel numbers off the end; what is left is the path
+        size_t end = line.size();
+        while (v.size() < 12) {
+          const size_t space = line.find_last_of(" \t", end - 1);
+          if (space == std::string::npos) 
+            break;
+          const std::string token = line.substr(space + 1, end - space - 1);
+          char* parsed = nullptr;
+          const float f = std::strtof(token.c_str(), &parsed);
+          if (token.empty() || parsed != token.c_str() + token.size()) 
+            break;
+          v.insert(v.begin(), f);
+          end = line.find_last_not_of(" \t", space);
+          if (end == std::string::npos) 
+            break;
+          ++end;
+        }
+        file.path = line.substr(0, end);
+      }
+      if (file.path.empty()) 
+        continue;
+      if (std::filesystem::path(file.path).is_relative()) 
+        file.path = (base / file.path).string();
+
+      if (v.size() == 3 || v.size() == 4) {
+        const float s = v.size() == 4 ? v[3] : 1.0f;
+        file.transform = glm::mat4(s);
+        file.transform[3] = glm::vec4(v[0], v[1], v[2], 1.0f);
+      } else if (v.size() == 12) {
+        for (int r = 0; r < 3; ++r) 
+          for (int c = 0; c < 4; ++c) 
+            file.transform[c][r] = v[r * 4 + c];
+      } else if (!v.empty()) {
+        printf("Ignoring malformed transform for '%s'\n", file.path.c_str());
+      }
+      files.push_back(std::move(file));
+    }
+    return load(files, threads, textures);
+  }
+
+  /**
+   * @brief Drops triangles whose bounds do not overlap a box.
+   *
+   * Vertex, normal and texture data are kept so indices stay valid, and 
+   * the scene bounds are not changed: tiles of one scene are built 
+   * relative to the full scene's bounds.
+   *
+   * @param box The region to keep.
+   * @return The number of triangles left.
+   */
+  inline size_t crop(const aabb_t& box) {
+    auto outside = [&](const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+      aabb_t tri;
+      tri.merge(a); tri.merge(b); tri.merge(c);
+      return !tri.intersects(box);
+    };
+
+    std::erase_if(m_indexed_tris, [&](const indexed_tri_t& t) {
+      return outside(m_vertices[t.vertices_idx[0]], m_vertices[t.vertices_idx[1]], m_vertices[t.vertices_idx[2]]);
+    });
+
+    size_t kept = 0;
+    for (size_t i = 0; i + 2 < m_triangles.size(); i += 3) {
+      if (outside(m_triangles[i], m_triangles[i + 1], m_triangles[i + 2]))
+        continue;
+      std::copy_n(m_triangles.begin() + i, 3, m_triangles.begin() + kept);
+      kept += 3;
+    }
+    m_triangles.resize(kept);
+    return get_triangles_count();
+  }
+
+  /**
+   * @brief Appends another scene, transformed, to this one.
+   *
+   * Vertex, normal, texture coordinate and material indices of `other` are 
+   * offset past the existing data. Texture coordinate index 0 keeps its 
+   * "untextured" meaning. Textures already loaded in `other` are moved in 
+   * under their resolved path, so the same image referenced by several 
+   * files is stored once. The bounding box is grown by the transformed 
+   * vertices.
+   *
+   * @param other The scene to append (its textures are moved out).
+   * @param transform Transform applied to the appended geometry.
+   * @param texture_dir Directory `other`'s texture names are relative to.
+   */
+  inline void merge(scene& other, const glm::mat4& transform, const std::string& texture_dir) {
+    const size_t vertex_offset   = m_vertices.size();
+    const size_t normal_offset   = m_normals.size();
+    const size_t tex_offset      = m_tex_coords.size();
+    const size_t material_offset = m_materials.size();
+    const glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+    m_vertices.reserve(vertex_offset + other.m_vertices.size());
+    for (const auto& v : other.m_vertices) {
+      m_vertices.push_back(glm::vec3(transform * glm::vec4(v, 1.0f)));
+      m_bbox.merge(m_vertices.back());
+    }
+
+    m_normals.reserve(normal_offset + other.m_normals.size());
+    for (const auto& n : other.m_normals) {
+      const glm::vec3 tn = normal_matrix * n;
+      const float len = glm::length(tn);
+      m_normals.push_back(len > 0.0f ? tn / len : tn);
+    }
+
+    m_tex_coords.insert(m_tex_coords.end(), other.m_tex_coords.begin(), other.m_tex_coords.end());
+
+    m_triangles.reserve(m_triangles.size() + other.m_triangles.size());
+    for (const auto& v : other.m_triangles) {
+      m_triangles.push_back(glm::vec3(transform * glm::vec4(v, 1.0f)));
+      m_bbox.merge(m_triangles.back());
+    }
+
+    for (auto material : other.m_materials) {
+      if (!material.texture.empty()) {
+        std::string tex_path = texture_dir + "/" + material.texture;
+        std::replace(tex_path.begin(), tex_path.end(), '\\', '/');
+        tex_path = std::filesystem::weakly_canonical(tex_path).string();
+        auto it = other.m_textures.find(material.texture);
+        if (it != other.m_textures.end() && m_textures.count(tex_path) == 0) 
+          m_textures[tex_path] = std::move(it->second);
+        material.texture = tex_path;
+      }
+      m_materials.push_back(std::move(material));
+    }
+
+    m_indexed_tris.reserve(m_indexed_tris.size() + other.m_indexed_tris.size());
+    for (auto tri : other.m_indexed_tris) {
+      for (size_t k = 0; k < 3; ++k) {
+        tri.vertices_idx[k] += vertex_offset;
+        tri.normals_idx[k]  += normal_offset;
+        if (tri.tex_coord_idx[k] != 0) 
+          tri.tex_coord_idx[k] += tex_offset;
+      }
+      tri.material_idx += material_offset;
+      m_indexed_tris.push_back(tri);
+    }
+
+    other = scene();
+  }
+
 public:
   // Read-write access (mutable)
   inline std::span<glm::vec3> get_vertices() { return m_vertices; }
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+#pragma once
+#ifndef TEXTURE_ATLAS_HPP
+#define TEXTURE_ATLAS_HPP
+
+#include <oasis/node_pool.hpp> // murmur_hasher32_t
+#include <oasis/scene.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @brief Packs 8-bit channels into one RGBA8 word (R in the low byte).
+ */
+constexpr uint32_t pack_rgba8(uint32_t r, uint32_t g, uint32_t b, uint32_t a = 255) {
+  return (std::min(r, 255u)) | (std::min(g, 255u) << 8) |
+         (std::min(b, 255u) << 16) | (std::min(a, 255u) << 24);
+}
+
+/**
+ * @brief Unpacks the RGB part of an RGBA8 word into a [0, 1] color.
+ */
+inline glm::vec3 unpack_rgb8(uint32_t p) {
+  return glm::vec3(float(p & 0xff), float((p >> 8) & 0xff), float((p >> 16) & 0xff)) / 255.0f;
+}
+
+/**
+ * @brief Converts a CImg image (1 to 4 channels) to packed RGBA8 pixels.
+ */
+template <typename T>
+inline std::vector<uint32_t> to_rgba8(const CImg<T>& img) {
+  const int w = img.width(), h = img.height(), c = img.spectrum();
+  std::vector<uint32_t> out(size_t(w) * h);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      const uint32_t r = uint32_t(img(x, y, 0, 0));
+      const uint32_t g = c > 1 ? uint32_t(img(x, y, 0, 1)) : r;
+      const uint32_t b = c > 2 ? uint32_t(img(x, y, 0, 2)) : r;
+      const uint32_t a = c > 3 ? uint32_t(img(x, y, 0, 3)) : 255u;
+      out[size_t(y) * w + x] = pack_rgba8(r, g, b, a);
+    }
+  }
+  return out;
+}
+
+/**
+ * @struct atlas_region_t
+ * @brief Placement of one unique image inside an atlas page.
+ */
+struct atlas_region_t {
+  uint32_t page;          ///< Index of the atlas page.
+  uint32_t x, y;          ///< Top-left pixel of the region in the page.
+  uint32_t width, height; ///< Size of the region in pixels.
+};
+
+/**
+ * @struct atlas_page_t
+ * @brief One contiguous RGBA8 atlas image.
+ */
+struct atlas_page_t {
+  uint32_t              width  = 0;
+  uint32_t              height = 0;
+  std::vector<uint32_t> pixels;   ///< Row-major packed RGBA8 pixels.
+};
+
+/**
+ * @class texture_atlas
+ * @brief Deduplicates scene textures and packs them into a few large pages.
+ *
+ * Images are identified by content (size and pixels), so one image
+ * referenced under several paths is stored once. Unique images are
+ * shelf-packed, tallest first, into square pages of `page_size` pixels;
+ * an image larger than a page gets a page of its own. Sampling reads
+ * from the page's contiguous RGBA8 storage.
+ *
+ * `build` leaves the scene's own `m_textures` untouched, as they are
+ * shared with the builder in liboasis. When only the atlas samples them
+ * (e.g. `node_pool_voxelizer::use_texture_atlas`), pass the map as an
+ * rvalue to release each image as soon as it has been converted.
+ */
+class texture_atlas {
+public:
+  /**
+   * @brief Constructs an empty atlas.
+   * @param page_size Edge length of an atlas page in pixels.
+   * @param padding Border in pixels left between packed images.
+   */
+  inline explicit texture_atlas(uint32_t page_size = 4096, uint32_t padding = 1)
+    : m_page_size(page_size), m_padding(padding) {}
+
+  /**
+   * @brief Builds the atlas from a scene's texture map.
+   *
+   * Replaces any previous content.
+   *
+   * @param textures The textures to pack, keyed by name.
+   * @return The number of unique images packed.
+   */
+  inline size_t build(const scene::texture_map& textures) {
+    return build_from(textures);
+  }
+
+  /// Builds the atlas, emptying `textures` one image at a time as they are converted.
+  inline size_t build(scene::texture_map&& textures) {
+    return build_from(textures);
+  }
+
+  /**
+   * @brief Looks up the region of a texture by name.
+   * @return The region id, or `std::nullopt` if the name is unknown.
+   */
+  inline std::optional<uint32_t> find(const std::string& name) const {
+    auto it = m_names.find(name);
+    if (it == m_names.end()) return std::nullopt;
+    return it->second;
+  }
+
+  /**
+   * @brief Resolves the region of every material's texture.
+   *
+   * Lets per-triangle sampling skip the name lookup.
+   *
+   * @return One region id per material, -1 for untextured materials.
+   */
+  inline std::vector<int32_t> bind_materials(std::span<const material_t> materials) const {
+    std::vector<int32_t> out(materials.size(), -1);
+    for (size_t i = 0; i < materials.size(); ++i) {
+      if (auto r = find(materials[i].texture))
+        out[i] = int32_t(*r);
+    }
+    return out;
+  }
+
+  /**
+   * @brief Maps a texture coordinate of a region to a page coordinate.
+   * @return Normalized coordinate in the region's page.
+   */
+  inline glm::vec2 remap_uv(uint32_t region, const glm::vec2& uv) const {
+    const auto& r = m_regions[region];
+    const auto& p = m_pages[r.page];
+    const glm::vec2 t = glm::clamp(uv, glm::vec2(0.0f), glm::vec2(1.0f));
+    return glm::vec2((r.x + t.x * r.width) / p.width, (r.y + t.y * r.height) / p.height);
+  }
+
+  /**
+   * @brief Fetches the nearest texel of a region as packed RGBA8.
+   */
+  inline uint32_t fetch(uint32_t region, const glm::vec2& uv) const {
+    const auto& r = m_regions[region];
+    const auto& p = m_pages[r.page];
+    const int x = std::clamp(static_cast<int>(uv[0] * r.width), 0, int(r.width) - 1);
+    const int y = std::clamp(static_cast<int>(uv[1] * r.height), 0, int(r.height) - 1);
+    return p.pixels[size_t(r.y + y) * p.width + r.x + x];
+  }
+
+  /**
+   * @brief Samples a region (nearest texel) as an RGB color in [0, 1].
+   */
+  inline glm::vec3 sample(uint32_t region, const glm::vec2& uv) const {
+    return unpack_rgb8(fetch(region, uv));
+  }
+
+  /**
+   * @brief Drop-in for `scene::get_tex_color` that samples the atlas.
+   * @return False (and leaves `c` unchanged) if the texture is unknown.
+   */
+  inline bool get_tex_color(const std::string& tex_name, const glm::vec2& uv, glm::vec3& c) const {
+    auto region = find(tex_name);
+    if (!region) return false;
+    c = sample(*region, uv);
+    return true;
+  }
+
+  inline std::span<const atlas_page_t> get_pages() const { return m_pages; }
+
+  inline std::span<const atlas_region_t> get_regions() const { return m_regions; }
+
+  /// Bytes of pixel storage held by all pages.
+  inline size_t memory_usage() const {
+    size_t bytes = 0;
+    for (const auto& p : m_pages)
+      bytes += p.pixels.size() * sizeof(uint32_t);
+    return bytes;
+  }
+
+private:
+  /// `build` over a const map, or over a mutable one that is emptied as it goes.
+  template <typename Map>
+  inline size_t build_from(Map& textures) {
+    m_pages.clear();
+    m_regions.clear();
+    m_names.clear();
+
+    // Dedup by content: hash -> unique image ids with that hash
+    struct image_t { uint32_t width, height; std::vector<uint32_t> pixels; };
+    std::vector<image_t> images;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> by_hash;
+    murmur_hasher32_t hasher;
+
+    for (auto next = textures.begin(); next != textures.end();) {
+      auto it = next++;
+      const auto& [name, texture] = *it;
+      if (texture.is_empty())
+        continue;
+      image_t img{uint32_t(texture.width()), uint32_t(texture.height()), to_rgba8(texture)};
+      const uint32_t h = hasher(std::span<const uint32_t>(img.pixels)) ^ (img.width * 0x9e3779b1u);
+
+      std::optional<uint32_t> found;
+      for (uint32_t id : by_hash[h]) {
+        const auto& other = images[id];
+        if (other.width == img.width && other.height == img.height && other.pixels == img.pixels) {
+          found = id;
+          break;
+        }
+      }
+      if (!found) {
+        found = uint32_t(images.size());
+        by_hash[h].push_back(*found);
+        images.push_back(std::move(img));
+      }
+      m_names[name] = *found;
+      if constexpr (!std::is_const_v<Map>)
+        textures.erase(it);
+    }
+
+    // Shelf packing, tallest images first
+    std::vector<uint32_t> order(images.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+      order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      return images[a].height != images[b].height ? images[a].height > images[b].height
+                                                   : images[a].width > images[b].width;
+    });
+
+    struct cursor_t { uint32_t x = 0, y = 0, shelf = 0; bool dedicated = false; };
+    std::vector<cursor_t> cursors;
+    m_regions.resize(images.size());
+
+    for (uint32_t id : order) {
+      const auto& img = images[id];
+
+      if (img.width > m_page_size || img.height > m_page_size) {
+        m_regions[id] = {uint32_t(m_pages.size()), 0, 0, img.width, img.height};
+        m_pages.push_back({img.width, img.height, {}});
+        cursors.push_back({0, 0, 0, true});
+        continue;
+      }
+
+      // First page with room, either on its open shelf or on a new one
+      std::optional<uint32_t> page;
+      cursor_t placed;
+      for (uint32_t p = 0; p < cursors.size() && !page; ++p) {
+        cursor_t c = cursors[p];
+        if (c.dedicated)
+          continue;
+        if (c.x + img.width > m_page_size) {
+          c = {0, c.y + c.shelf, 0, false};
+        }
+        if (c.y + img.height <= m_page_size) {
+          page = p;
+          placed = c;
+        }
+      }
+      if (!page) {
+        page = uint32_t(m_pages.size());
+        m_pages.push_back({m_page_size, m_page_size, {}});
+        cursors.push_back({});
+      }
+
+      m_regions[id] = {*page, placed.x, placed.y, img.width, img.height};
+      placed.x += img.width + m_padding;
+      placed.shelf = std::max(placed.shelf, img.height + m_padding);
+      cursors[*page] = placed;
+    }
+
+    // Copy pixels into the pages
+    for (auto& page : m_pages)
+      page.pixels.assign(size_t(page.width) * page.height, 0);
+    for (uint32_t id = 0; id < images.size(); ++id) {
+      const auto& r = m_regions[id];
+      auto& page = m_pages[r.page];
+      for (uint32_t y = 0; y < r.height; ++y) {
+        std::copy_n(images[id].pixels.data() + size_t(y) * r.width, r.width,
+                    page.pixels.data() + size_t(r.y + y) * page.width + r.x);
+      }
+    }
+    return images.size();
+  }
+  uint32_t                                  m_page_size; ///< Edge length of a regular page.
+  uint32_t                                  m_padding;   ///< Gap between packed images.
+  std::vector<atlas_page_t>                 m_pages;     ///< Atlas images.
+  std::vector<atlas_region_t>               m_regions;   ///< One region per unique image.
+  std::unordered_map<std::string, uint32_t> m_names;     ///< Texture name -> region.
+};
+
+} // namespace oasis
+
+#endif // TEXTURE_ATLAS_HPP
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+#pragma once
+#ifndef TEXTURE_CACHE_HPP
+#define TEXTURE_CACHE_HPP
+
+#include <oasis/texture_atlas.hpp> // pack_rgba8, to_rgba8
+#include <oasis/scene.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @enum texture_format_t
+ * @brief In-memory storage format of a cached texture.
+ */
+enum class texture_format_t {
+  rgba8, ///< 4 bytes per texel, lossless.
+  bc1    ///< 4x4 blocks of two RGB565 endpoints and 2-bit indices (0.5 bytes per texel, opaque).
+};
+
+/**
+ * @brief Encodes 8-bit RGB to RGB565.
+ */
+constexpr uint16_t to_rgb565(uint32_t rgba) {
+  return uint16_t((((rgba & 0xff) >> 3) << 11) | ((((rgba >> 8) & 0xff) >> 2) << 5) | (((rgba >> 16) & 0xff) >> 3));
+}
+
+/**
+ * @brief Decodes RGB565 to packed RGBA8 (opaque).
+ */
+constexpr uint32_t from_rgb565(uint16_t c) {
+  const uint32_t r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+  return pack_rgba8((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+/**
+ * @brief Compresses RGBA8 pixels into BC1 blocks.
+ *
+ * Endpoints are the per-block RGB bounding box, which is fast and good
+ * enough for albedo lookups. Edge blocks repeat the last row/column.
+ *
+ * @return `ceil(w/4) * ceil(h/4)` blocks of 8 bytes (two 565 endpoints
+ *         in the low 32 bits, 16 2-bit indices in the high 32 bits).
+ */
+inline std::vector<uint64_t> encode_bc1(std::span<const uint32_t> pixels, uint32_t width, uint32_t height) {
+  const uint32_t bw = (width + 3) / 4, bh = (height + 3) / 4;
+  std::vector<uint64_t> blocks(size_t(bw) * bh);
+
+  for (uint32_t by = 0; by < bh; ++by) {
+    for (uint32_t bx = 0; bx < bw; ++bx) {
+      glm::ivec3 texels[16];
+      glm::ivec3 lo(255), hi(0);
+      for (uint32_t i = 0; i < 16; ++i) {
+        const uint32_t x = std::min(bx * 4 + (i & 3), width - 1);
+        const uint32_t y = std::min(by * 4 + (i >> 2), height - 1);
+        const uint32_t p = pixels[size_t(y) * width + x];
+        texels[i] = glm::ivec3(p & 0xff, (p >> 8) & 0xff, (p >> 16) & 0xff);
+        lo = glm::min(lo, texels[i]);
+        hi = glm::max(hi, texels[i]);
+      }
+
+      uint16_t c0 = to_rgb565(pack_rgba8(hi.x, hi.y, hi.z));
+      uint16_t c1 = to_rgb565(pack_rgba8(lo.x, lo.y, lo.z));
+      if (c0 < c1) std::swap(c0, c1);
+
+      uint64_t indices = 0;
+      if (c0 != c1) {
+        // 4-color mode: c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1
+        glm::ivec3 palette[4];
+        const uint32_t e0 = from_rgb565(c0), e1 = from_rgb565(c1);
+        palette[0] = glm::ivec3(e0 & 0xff, (e0 >> 8) & 0xff, (e0 >> 16) & 0xff);
+        palette[1] = glm::ivec3(e1 & 0xff, (e1 >> 8) & 0xff, (e1 >> 16) & 0xff);
+        palette[2] = (palette[0] * 2 + palette[1]) / 3;
+        palette[3] = (palette[0] + palette[1] * 2) / 3;
+        for (uint32_t i = 0; i < 16; ++i) {
+          uint32_t best = 0;
+          int best_d = std::numeric_limits<int>::max();
+          for (uint32_t k = 0; k < 4; ++k) {
+            const glm::ivec3 d = texels[i] - palette[k];
+            const int dd = glm::dot(d, d);
+            if (dd < best_d) { best_d = dd; best = k; }
+          }
+          indices |= uint64_t(best) << (2 * i);
+        }
+      }
+      blocks[size_t(by) * bw + bx] = uint64_t(c0) | (uint64_t(c1) << 16) | (indices << 32);
+    }
+  }
+  return blocks;
+}
+
+/**
+ * @brief Decodes one texel of a BC1 image as packed RGBA8.
+ */
+inline uint32_t decode_bc1_texel(std::span<const uint64_t> blocks, uint32_t width, uint32_t x, uint32_t y) {
+  const uint64_t block = blocks[size_t(y >> 2) * ((width + 3) / 4) + (x >> 2)];
+  const uint16_t c0 = uint16_t(block), c1 = uint16_t(block >> 16);
+  const uint32_t index = uint32_t(block >> (32 + 2 * ((y & 3) * 4 + (x & 3)))) & 3;
+  if (index < 2 || c0 == c1)
+    return from_rgb565(index == 1 ? c1 : c0);
+
+  const uint32_t e0 = from_rgb565(c0), e1 = from_rgb565(c1);
+  const uint32_t w0 = index == 2 ? 2 : 1, w1 = 3 - w0;
+  uint32_t out = 0xff000000u;
+  for (uint32_t s = 0; s < 24; s += 8)
+    out |= ((((e0 >> s) & 0xff) * w0 + ((e1 >> s) & 0xff) * w1) / 3) << s;
+  return out;
+}
+
+/**
+ * @class texture_cache
+ * @brief Texture storage with compact formats and a global memory budget.
+ *
+ * Textures registered by path are loaded on first use and converted to
+ * packed RGBA8 or BC1 (a 3x or 24x saving over the 3 x 32-bit channels
+ * `scene::m_textures` holds). When the resident size exceeds the budget
+ * the least recently sampled textures are evicted and reloaded from disk
+ * on their next use. Textures added from memory have no source to reload
+ * from, so they are pinned.
+ *
+ * All public functions are thread safe.
+ */
+class texture_cache {
+public:
+  /**
+   * @brief Constructs an empty cache.
+   * @param budget_bytes Resident texture budget (0 = unlimited).
+   * @param format Storage format for textures added from now on.
+   */
+  inline explicit texture_cache(size_t budget_bytes = 0, texture_format_t format = texture_format_t::rgba8)
+    : m_budget(budget_bytes), m_format(format) {}
+
+  /**
+   * @brief Registers a texture file to be loaded on first use.
+   * @return The texture id (the existing one if `name` is known).
+   */
+  inline uint32_t add(const std::string& name, const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (auto it = m_names.find(name); it != m_names.end())
+      return it->second;
+    const uint32_t id = uint32_t(m_entries.size());
+    m_entries.push_back({});
+    m_entries.back().path = path;
+    m_entries.back().format = m_format;
+    m_names[name] = id;
+    return id;
+  }
+
+  /**
+   * @brief Adds an image that is already in memory (pinned).
+   * @return The texture id.
+   */
+  template <typename T>
+  inline uint32_t add(const std::string& name, const CImg<T>& image) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t id;
+    if (auto it = m_names.find(name); it != m_names.end()) {
+      id = it->second;
+      unload(m_entries[id]);
+    } else {
+      id = uint32_t(m_entries.size());
+      m_entries.push_back({});
+      m_names[name] = id;
+    }
+    auto& e = m_entries[id];
+    e.format = m_format;
+    e.pinned = true;
+    store(e, image);
+    enforce_budget(id);
+    return id;
+  }
+
+  /**
+   * @brief Registers the textures of a set of materials.
+   *
+   * Mirrors `scene::load_textures` (material 0 is skipped, names are
+   * relative to `path`) but defers loading to first use.
+   *
+   * @return False if there were no materials.
+   */
+  inline bool add_materials(std::span<const material_t> materials, const std::string& path) {
+    for (size_t i = 1; i < materials.size(); ++i) {
+      const std::string& name = materials[i].texture;
+      if (name.size() <= 3)
+        continue;
+      std::string tex_path = std::filesystem::path(name).is_absolute() ? name : path + "/" + name;
+      std::replace(tex_path.begin(), tex_path.end(), '\\', '/');
+      add(name, tex_path);
+    }
+    return !materials.empty();
+  }
+
+  inline std::optional<uint32_t> find(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_names.find(name);
+    if (it == m_names.end()) return std::nullopt;
+    return it->second;
+  }
+
+  /**
+   * @brief Fetches the nearest texel of a texture as packed RGBA8.
+   *
+   * Loads the texture if it is not resident.
+   *
+   * @return `std::nullopt` if the texture could not be loaded.
+   */
+  inline std::optional<uint32_t> fetch(uint32_t id, const glm::vec2& uv) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& e = m_entries[id];
+    if (!e.resident()) {
+      if (!load(e)) return std::nullopt;
+      enforce_budget(id);
+    } else {
+      ++m_stats.hits;
+    }
+    if (!e.pinned)
+      m_lru.splice(m_lru.begin(), m_lru, e.lru);
+
+    const int x = std::clamp(static_cast<int>(uv[0] * e.width), 0, int(e.width) - 1);
+    const int y = std::clamp(static_cast<int>(uv[1] * e.height), 0, int(e.height) - 1);
+    return e.format == texture_format_t::bc1 ? decode_bc1_texel(e.blocks, e.width, x, y)
+                                             : e.pixels[size_t(y) * e.width + x];
+  }
+
+  /**
+   * @brief Drop-in for `scene::get_tex_color` backed by the cache.
+   * @return False (and leaves `c` unchanged) if the texture is unavailable.
+   */
+  inline bool get_tex_color(const std::string& tex_name, const glm::vec2& uv, glm::vec3& c) {
+    auto id = find(tex_name);
+    if (!id) return false;
+    auto texel = fetch(*id, uv);
+    if (!texel) return false;
+    c = unpack_rgb8(*texel);
+    return true;
+  }
+
+  /// Sets the resident budget in bytes (0 = unlimited) and evicts down to it.
+  inline void set_budget(size_t budget_bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budget_bytes;
+    enforce_budget(std::nullopt);
+  }
+
+  inline size_t get_budget() const { std::lock_guard<std::mutex> lock(m_mutex); return m_budget; }
+
+  /// Bytes of texel storage currently resident.
+  inline size_t memory_usage() const { std::lock_guard<std::mutex> lock(m_mutex); return m_resident; }
+
+  /**
+   * @struct stats_t
+   * @brief Cache activity counters.
+   */
+  struct stats_t {
+    uint64_t hits      = 0; ///< Fetches served from a resident texture.
+    uint64_t loads     = 0; ///< Textures loaded (first use or after eviction).
+    uint64_t evictions = 0; ///< Textures dropped to stay within budget.
+    uint64_t failures  = 0; ///< Loads that failed.
+  };
+
+  inline stats_t get_stats() const { std::lock_guard<std::mutex> lock(m_mutex); return m_stats; }
+
+private:
+  struct entry_t {
+    std::string                    path;
+    texture_format_t               format = texture_format_t::rgba8;
+    bool                           pinned = false;
+    bool                           failed = false;
+    uint32_t                       width  = 0;
+    uint32_t                       height = 0;
+    std::vector<uint32_t>          pixels; ///< RGBA8 texels.
+    std::vector<uint64_t>          blocks; ///< BC1 blocks.
+    std::list<uint32_t>::iterator  lru;    ///< Position in m_lru (unpinned and resident only).
+
+    inline bool resident() const { return !pixels.empty() || !blocks.empty(); }
+    inline size_t bytes() const { return pixels.size() * sizeof(uint32_t) + blocks.size() * sizeof(uint64_t); }
+  };
+
+  template <typename T>
+  inline void store(entry_t& e, const CImg<T>& image) {
+    e.width = uint32_t(image.width());
+    e.height = uint32_t(image.height());
+    std::vector<uint32_t> rgba = to_rgba8(image);
+    if (e.format == texture_format_t::bc1) {
+      e.blocks = encode_bc1(rgba, e.width, e.height);
+    } else {
+      e.pixels = std::move(rgba);
+    }
+    m_resident += e.bytes();
+  }
+
+  inline bool load(entry_t& e) {
+    if (e.failed || e.path.empty())
+      return false;
+    try {
+      CImg<unsigned char> image(e.path.c_str());
+      if (image.is_empty()) throw CImgIOException("empty image");
+      store(e, image);
+    } catch (const CImgException& ex) {
+      printf("Failed to load texture '%s': %s\n", e.path.c_str(), ex.what());
+      e.failed = true;
+      ++m_stats.failures;
+      return false;
+    }
+    ++m_stats.loads;
+    m_lru.push_front(uint32_t(&e - m_entries.data()));
+    e.lru = m_lru.begin();
+    return true;
+  }
+
+  inline void unload(entry_t& e) {
+    if (!e.resident()) return;
+    m_resident -= e.bytes();
+    e.pixels = {};
+    e.blocks = {};
+    if (!e.pinned)
+      m_lru.erase(e.lru);
+  }
+
+  inline void enforce_budget(std::optional<uint32_t> keep) {
+    if (m_budget == 0) return;
+    auto it = m_lru.end();
+    while (m_resident > m_budget && it != m_lru.begin()) {
+      auto victim = std::prev(it);
+      if (keep && *victim == *keep) {
+        it = victim;
+        continue;
+      }
+      unload(m_entries[*victim]); // erases victim, `it` stays valid
+      ++m_stats.evictions;
+    }
+  }
+
+  mutable std::mutex                        m_mutex;
+  size_t                                    m_budget;       ///< Resident budget in bytes (0 = unlimited).
+  texture_format_t                          m_format;       ///< Format for newly added textures.
+  size_t                                    m_resident = 0; ///< Bytes currently resident.
+  std::vector<entry_t>                      m_entries;
+  std::unordered_map<std::string, uint32_t> m_names;        ///< Texture name -> id.
+  std::list<uint32_t>                       m_lru;          ///< Resident unpinned ids, most recent first.
+  stats_t                                   m_stats;
+};
+
+} // namespace oasis
+
+#endif // TEXTURE_CACHE_HPP
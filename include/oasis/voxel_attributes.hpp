@@ -0,0 +1,397 @@
+/*
+ * Copyright (c) 2025 REFUGE STUDIOS PTY LTD. All rights reserved.
+ *
+ * This software is licensed for use as an API in projects developed by
+ * third-party clients, subject to the following conditions:
+ *
+ * - Clients may use this API for integration into their own applications.
+ * - Redistribution, sublicensing, or modification of the API itself is prohibited.
+ * - Reverse engineering, decompilation, or disassembly of this software is not allowed.
+ * - This software must not be used to develop competing services or products.
+ * - Any project using this API must include the attribution:
+ *   "Powered by Refuge Studios."
+ *
+ * Refuge Studios retains full ownership and control over this software.
+ * Access to updates and support is provided at the discretion of Refuge Studios.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS," WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * REFUGE STUDIOS BE LIABLE FOR ANY CLAIM, DAMAGES, OR OTHER LIABILITY ARISING
+ * FROM THE USE OF THIS SOFTWARE.
+ */
+
+#pragma once
+#ifndef VOXEL_ATTRIBUTES_HPP
+#define VOXEL_ATTRIBUTES_HPP
+
+#include <oasis/node_pool.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace oasis {
+
+/**
+ * @brief Encodes a unit normal as 16-bit octahedral (8 bits per axis).
+ */
+inline uint16_t encode_oct16(glm::vec3 n) {
+  const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+  if (l1 <= 0.0f) return 0x8080; // +z
+  n /= l1;
+  glm::vec2 e(n.x, n.y);
+  if (n.z < 0.0f) {
+    e = glm::vec2((1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                  (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+  }
+  const uint32_t u = uint32_t(std::lround((e.x * 0.5f + 0.5f) * 255.0f));
+  const uint32_t v = uint32_t(std::lround((e.y * 0.5f + 0.5f) * 255.0f));
+  return uint16_t(u | (v << 8));
+}
+
+/**
+ * @brief Decodes a 16-bit octahedral normal.
+ */
+inline glm::vec3 decode_oct16(uint16_t oct) {
+  const glm::vec2 e = glm::vec2(float(oct & 0xff), float(oct >> 8)) / 255.0f * 2.0f - glm::vec2(1.0f);
+  glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+  if (n.z < 0.0f) {
+    n.x = (1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f);
+    n.y = (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f);
+  }
+  return glm::normalize(n);
+}
+
+/**
+ * @struct voxel_attribute_t
+ * @brief Attributes of one voxel.
+ */
+struct voxel_attribute_t {
+  uint16_t normal   = 0x8080; ///< Octahedral-encoded surface normal.
+  uint32_t material = 0;      ///< Scene material index.
+
+  inline glm::vec3 get_normal() const { return decode_oct16(normal); }
+};
+
+/**
+ * @class voxel_attributes
+ * @brief Compressed per-voxel attribute stream in leaf order.
+ *
+ * The DAG shares identical subtrees, so attributes cannot live in the
+ * nodes. Instead every set voxel of the expanded tree gets a rank (its
+ * position in depth-first, child-slot order) and the attributes are
+ * stored in rank order. Per node, `prefix` holds how many voxels precede
+ * each child slot within that subtree. A traversal that ends holding the
+ * node path to its leaf (`query_ray_fixed`, `traversal_context`) sums one
+ * table read per level of that path, without reading nodes again, and
+ * fetches the attribute with one more read into the stream.
+ *
+ * The stream is split into blocks of `block_size` voxels. Each block
+ * stores the minimum of each field and the per-voxel differences at the
+ * smallest bit width that fits (frame-of-reference delta coding).
+ * Materials are first mapped through a palette of the ids in use.
+ */
+class voxel_attributes {
+public:
+  static constexpr uint32_t block_size = 64;
+
+  /// Per-node voxel counts before each child slot; `build` rejects pools over 2^32 - 1 voxels.
+  using prefix_t = std::array<uint32_t, 8>;
+
+  /// Default constructor.
+  explicit voxel_attributes() = default;
+
+  /**
+   * @brief Builds the stream for a pool.
+   *
+   * @param nodes The pool's nodes, root at index 0, children at higher
+   *        indices than their parents (the builders' layout).
+   * @param attributes One entry per voxel, in leaf order.
+   * @return False if the number of attributes does not match the pool, or
+   *         the pool holds more voxels than `prefix_t` can count.
+   */
+  inline bool build(std::span<const node_t<int>> nodes, std::span<const voxel_attribute_t> attributes) {
+    const auto voxels = build_prefix(nodes);
+    if (!voxels || *voxels != attributes.size()) {
+      clear();
+      return false;
+    }
+
+    // Material palette
+    m_palette.clear();
+    std::unordered_map<uint32_t, uint32_t> palette_index;
+    for (const auto& a : attributes) {
+      if (palette_index.try_emplace(a.material, uint32_t(m_palette.size())).second)
+        m_palette.push_back(a.material);
+    }
+
+    m_blocks.clear();
+    m_bits.clear();
+    m_count = attributes.size();
+    uint64_t bit = 0;
+    for (size_t first = 0; first < attributes.size(); first += block_size) {
+      const size_t last = std::min(attributes.size(), first + block_size);
+      block_t b{};
+      uint32_t umin = 255, vmin = 255, umax = 0, vmax = 0, mmin = ~0u, mmax = 0;
+      for (size_t i = first; i < last; ++i) {
+        const uint32_t u = attributes[i].normal & 0xff, v = attributes[i].normal >> 8;
+        const uint32_t m = palette_index[attributes[i].material];
+        umin = std::min(umin, u); umax = std::max(umax, u);
+        vmin = std::min(vmin, v); vmax = std::max(vmax, v);
+        mmin = std::min(mmin, m); mmax = std::max(mmax, m);
+      }
+      b.bit_offset = bit;
+      b.umin = uint8_t(umin);
+      b.vmin = uint8_t(vmin);
+      b.mmin = mmin;
+      b.ubits = uint8_t(std::bit_width(umax - umin));
+      b.vbits = uint8_t(std::bit_width(vmax - vmin));
+      b.mbits = uint8_t(std::bit_width(mmax - mmin));
+      const uint32_t stride = b.ubits + b.vbits + b.mbits;
+
+      for (size_t i = first; i < last; ++i) {
+        const uint64_t u = (attributes[i].normal & 0xff) - umin;
+        const uint64_t v = (attributes[i].normal >> 8) - vmin;
+        const uint64_t m = palette_index[attributes[i].material] - mmin;
+        write_bits(bit, u | (v << b.ubits) | (m << (b.ubits + b.vbits)), stride);
+        bit += stride;
+      }
+      m_blocks.push_back(b);
+    }
+    m_bits.push_back(0); // read_bits may touch one word past the end
+    return true;
+  }
+
+  /// Number of voxels in the stream.
+  inline size_t size() const { return m_count; }
+
+  /// Rank table of node `index` (for traversals accumulating ranks).
+  inline const prefix_t& get_prefix(size_t index) const { return m_prefix[index]; }
+
+  /**
+   * @brief Rank of the leaf a traversal stopped on, from the path it holds.
+   *
+   * @param stack Node indices from the root (`stack[0]`) down to the leaf's parent (`stack[level]`).
+   * @param level Level of the leaf's parent.
+   * @param voxel Integer voxel coordinate inside the leaf, at `depth`.
+   * @param depth Depth the pool was built with.
+   */
+  inline uint64_t rank(const int* stack, uint32_t level, glm::uvec3 voxel, uint32_t depth) const {
+    uint64_t rank = 0;
+    for (uint32_t l = 0; l <= level; ++l) {
+      const uint32_t shift = depth - l - 1;
+      rank += m_prefix[stack[l]][((voxel.x >> shift) & 1) | (((voxel.y >> shift) & 1) << 1) | (((voxel.z >> shift) & 1) << 2)];
+    }
+    return rank;
+  }
+
+  /**
+   * @brief Decodes the attributes of the voxel with the given rank.
+   */
+  inline voxel_attribute_t get(uint64_t rank) const {
+    const block_t& b = m_blocks[rank / block_size];
+    const uint32_t stride = b.ubits + b.vbits + b.mbits;
+    const uint64_t word = read_bits(b.bit_offset + (rank % block_size) * stride, stride);
+    voxel_attribute_t a;
+    const uint32_t u = b.umin + uint32_t(word & ((1u << b.ubits) - 1));
+    const uint32_t v = b.vmin + uint32_t((word >> b.ubits) & ((1u << b.vbits) - 1));
+    a.normal = uint16_t(u | (v << 8));
+    a.material = m_palette[b.mmin + uint32_t((word >> (b.ubits + b.vbits)) & ((1ull << b.mbits) - 1))];
+    return a;
+  }
+
+  /**
+   * @brief Finds the rank of a voxel by descending from the root.
+   *
+   * For hits that only carry a position (e.g. `node_pool_traversal`);
+   * this reads every node on the path again. Traversals that hold the
+   * path should use `rank` instead.
+   *
+   * @param nodes The pool the stream was built for.
+   * @param voxel Integer voxel coordinate at `depth`.
+   * @param depth Depth the pool was built with.
+   * @return The rank, or `std::nullopt` if the voxel is empty.
+   */
+  inline std::optional<uint64_t> locate(std::span<const node_t<int>> nodes, glm::uvec3 voxel, uint32_t depth) const {
+    if (nodes.empty()) return std::nullopt;
+    uint64_t rank = 0;
+    int node = 0;
+    for (uint32_t level = depth; level-- > 0;) {
+      const uint32_t slot = ((voxel.x >> level) & 1) | (((voxel.y >> level) & 1) << 1) | (((voxel.z >> level) & 1) << 2);
+      rank += m_prefix[node][slot];
+      const int child = nodes[node].children[slot];
+      if (child == 0) return std::nullopt;
+      if (child < 0) return rank;
+      node = child - 1;
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Finds the attributes at a world-space point.
+   *
+   * @param nodes The pool the stream was built for.
+   * @param p Point inside the voxel (e.g. a traversal hit nudged along the ray).
+   * @param corner Minimum corner the pool was built with.
+   * @param size Edge length the pool was built with.
+   * @param depth Depth the pool was built with.
+   */
+  inline std::optional<voxel_attribute_t> at(std::span<const node_t<int>> nodes, glm::vec3 p,
+                                             glm::vec3 corner, float size, uint32_t depth) const {
+    const float res = float(1u << depth);
+    const glm::vec3 g = glm::floor((p - corner) / size * res);
+    if (g.x < 0 || g.y < 0 || g.z < 0 || g.x >= res || g.y >= res || g.z >= res)
+      return std::nullopt;
+    auto rank = locate(nodes, glm::uvec3(g), depth);
+    if (!rank) return std::nullopt;
+    return get(*rank);
+  }
+
+  /// Bytes used by the stream, palette and block table (without rank tables).
+  inline size_t stream_bytes() const {
+    return m_bits.size() * sizeof(uint64_t) + m_blocks.size() * sizeof(block_t) + m_palette.size() * sizeof(uint32_t);
+  }
+
+  /// Bytes used by the per-node rank tables.
+  inline size_t prefix_bytes() const { return m_prefix.size() * sizeof(prefix_t); }
+
+  /// Writes the stream; the rank tables are rebuilt from the pool on `read`.
+  inline bool write(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    const uint64_t header[4] = {m_count, m_palette.size(), m_blocks.size(), m_bits.size()};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(m_palette.data()), m_palette.size() * sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(m_blocks.data()), m_blocks.size() * sizeof(block_t));
+    out.write(reinterpret_cast<const char*>(m_bits.data()), m_bits.size() * sizeof(uint64_t));
+    return bool(out);
+  }
+
+  /**
+   * @brief Reads a stream written by `write` for the given pool.
+   * @return False if the file is malformed or was written for a pool with a different voxel count.
+   */
+  inline bool read(const std::string& filename, std::span<const node_t<int>> nodes) {
+    clear();
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    const uint64_t file_bytes = uint64_t(in.tellg());
+    in.seekg(0);
+    uint64_t header[4];
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        header[2] != (header[0] + block_size - 1) / block_size || header[3] == 0 ||
+        header[1] > file_bytes / sizeof(uint32_t) || header[2] > file_bytes / sizeof(block_t) ||
+        header[3] > file_bytes / sizeof(uint64_t) ||
+        file_bytes != sizeof(header) + header[1] * sizeof(uint32_t) + header[2] * sizeof(block_t) + header[3] * sizeof(uint64_t))
+      return false;
+    m_palette.resize(header[1]);
+    m_blocks.resize(header[2]);
+    m_bits.resize(header[3]);
+    if (!in.read(reinterpret_cast<char*>(m_palette.data()), m_palette.size() * sizeof(uint32_t)) ||
+        !in.read(reinterpret_cast<char*>(m_blocks.data()), m_blocks.size() * sizeof(block_t)) ||
+        !in.read(reinterpret_cast<char*>(m_bits.data()), m_bits.size() * sizeof(uint64_t))) {
+      clear();
+      return false;
+    }
+
+    // Every decode must stay inside the stream and the palette
+    const uint64_t stream_bits = m_bits.size() * 64;
+    for (size_t i = 0; i < m_blocks.size(); ++i) {
+      const block_t& b = m_blocks[i];
+      const uint64_t n = std::min<uint64_t>(block_size, header[0] - i * block_size);
+      const uint64_t stride = uint64_t(b.ubits) + b.vbits + b.mbits;
+      bool valid = b.ubits <= 8 && b.vbits <= 8 && b.mbits <= 32 && 
+                   b.bit_offset <= stream_bits && n * stride <= stream_bits - b.bit_offset;
+      for (uint64_t k = 0; valid && k < n; ++k) {
+        const uint64_t word = read_bits(b.bit_offset + k * stride, uint32_t(stride));
+        valid = b.mmin + ((word >> (b.ubits + b.vbits)) & ((1ull << b.mbits) - 1)) < m_palette.size();
+      }
+      if (!valid) {
+        clear();
+        return false;
+      }
+    }
+    const auto voxels = build_prefix(nodes);
+    if (!voxels || *voxels != header[0]) {
+      clear();
+      return false;
+    }
+    m_count = header[0];
+    return true;
+  }
+
+private:
+  struct block_t {
+    uint64_t bit_offset;   ///< Start of the block in m_bits.
+    uint32_t mmin;         ///< Smallest palette index in the block.
+    uint8_t  umin, vmin;   ///< Smallest octahedral coordinates in the block.
+    uint8_t  ubits, vbits; ///< Bit widths of the normal deltas.
+    uint8_t  mbits;        ///< Bit width of the palette delta.
+  };
+
+  /// Fills the rank tables; returns the pool's voxel count, or nothing if `prefix_t` cannot hold it.
+  inline std::optional<uint64_t> build_prefix(std::span<const node_t<int>> nodes) {
+    m_prefix.assign(nodes.size(), prefix_t{});
+    std::vector<uint64_t> counts(nodes.size(), 0);
+    for (size_t i = nodes.size(); i-- > 0;) {
+      uint64_t total = 0;
+      for (uint32_t s = 0; s < 8; ++s) {
+        m_prefix[i][s] = uint32_t(total);
+        const int c = nodes[i].children[s];
+        total += c < 0 ? 1 : c > 0 ? counts[c - 1] : 0;
+      }
+      counts[i] = total;
+    }
+    // Every subtree holds at most the root's voxels
+    const uint64_t voxels = nodes.empty() ? 0 : counts[0];
+    if (voxels > std::numeric_limits<uint32_t>::max()) return std::nullopt;
+    return voxels;
+  }
+
+  inline void clear() {
+    m_prefix.clear();
+    m_palette.clear();
+    m_blocks.clear();
+    m_bits.clear();
+    m_count = 0;
+  }
+
+  inline void write_bits(uint64_t bit, uint64_t value, uint32_t count) {
+    if (count == 0) return;
+    const size_t word = bit >> 6;
+    const uint32_t shift = bit & 63;
+    if (m_bits.size() < word + 2) m_bits.resize(word + 2, 0);
+    m_bits[word] |= value << shift;
+    if (shift + count > 64)
+      m_bits[word + 1] |= value >> (64 - shift);
+  }
+
+  inline uint64_t read_bits(uint64_t bit, uint32_t count) const {
+    if (count == 0) return 0;
+    const size_t word = bit >> 6;
+    const uint32_t shift = bit & 63;
+    uint64_t value = m_bits[word] >> shift;
+    if (shift + count > 64)
+      value |= m_bits[word + 1] << (64 - shift);
+    return count == 64 ? value : value & ((1ull << count) - 1);
+  }
+
+  std::vector<prefix_t> m_prefix;  ///< Per-node voxel counts before each slot.
+  std::vector<uint32_t> m_palette; ///< Palette index -> material id.
+  std::vector<block_t>  m_blocks;  ///< One descriptor per block_size voxels.
+  std::vector<uint64_t> m_bits;    ///< Packed per-voxel deltas.
+  size_t                m_count = 0;
+};
+
+} // namespace oasis
+
+#endif // VOXEL_ATTRIBUTES_HPP
@@ -4,77 +4,1364 @@
 #define ASSIMP_SCENE_ENABLED
 #include <oasis/node_pool.hpp>
 #include <oasis/node_pool_builder.hpp>
+#include <oasis/node_pool_voxelizer.hpp>
+#include <oasis/node_pool_tiler.hpp>
+#include <oasis/node_pool_traversal.hpp>
+#include <oasis/node_pool_server.hpp>
+#include <oasis/node_pool_writer.hpp>
+#include <oasis/node_pool_fixed_traversal.hpp>
+#include <oasis/node_pool_beam.hpp>
+#include <oasis/node_pool_hit_cache.hpp>
+#include <oasis/node_pool_visibility.hpp>
+#include <oasis/node_pool_analytics.hpp>
+#include <oasis/node_pool_defrag.hpp>
+#include <oasis/node_pool_profile.hpp>
+#include <oasis/node_pool_sequence.hpp>
+#include <oasis/node_pool_compact.hpp>
+#include <oasis/node_pool_implicit_top.hpp>
+#include <oasis/node_pool_line_of_sight.hpp>
 #include <oasis/scene.hpp>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+// Blocking FIFO with a fixed capacity, used between batch pipeline stages
+template <typename T>
+class bounded_queue {
+public:
+  explicit bounded_queue(size_t capacity) : m_capacity(std::max<size_t>(1, capacity)) {}
+
+  // Waits for room; returns false if the queue was closed
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [&] { return m_items.size() < m_capacity || m_closed; });
+    if (m_closed) {
+      return false;
+    }
+    m_items.push_back(std::move(item));
+    m_not_empty.notify_one();
+    return true;
+  }
+
+  // Waits for an item; returns nullopt once the queue is closed and drained
+  std::optional<T> pop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_empty.wait(lock, [&] { return !m_items.empty() || m_closed; });
+    if (m_items.empty()) {
+      return std::nullopt;
+    }
+    T item = std::move(m_items.front());
+    m_items.pop_front();
+    m_not_full.notify_one();
+    return item;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
 
-class dag_node_pool final : public virtual oasis::node_pool, public oasis::node_pool_builder {
+private:
+  size_t                  m_capacity;
+  bool                    m_closed = false;
+  std::deque<T>           m_items;
+  std::mutex              m_mutex;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+};
+
+class dag_node_pool final : public virtual oasis::node_pool, 
+                            public oasis::node_pool_builder, 
+                            public oasis::node_pool_voxelizer, 
+                            public oasis::node_pool_tiler, 
+                            public oasis::node_pool_defrag, 
+                            public oasis::node_pool_sequence, 
+                            public oasis::node_pool_traversal {
 private:
   friend class oasis::node_pool;
 
 public:
-  inline dag_node_pool() : oasis::node_pool(), oasis::node_pool_builder() {}
+  inline dag_node_pool() : oasis::node_pool(), oasis::node_pool_builder(), 
+                           oasis::node_pool_voxelizer(), oasis::node_pool_tiler(), 
+                           oasis::node_pool_defrag(), oasis::node_pool_sequence() {}
 
   inline ~dag_node_pool() final = default;
 
-  bool create(const std::string filename, const std::string out_filename, uint8_t depth) {
-    oasis::scene scene;
+  // A text file listing model files (one per line) rather than a model itself
+  static bool is_manifest(const std::string& filename) {
+    const std::string ext = std::filesystem::path(filename).extension().string();
+    return ext == ".txt" || ext == ".manifest";
+  }
+
+  static const char* mode_name(oasis::voxelization_mode_t mode) {
+    switch (mode) {
+    case oasis::voxelization_mode_t::conservative:  return "conservative";
+    case oasis::voxelization_mode_t::separating_26: return "26-separating";
+    case oasis::voxelization_mode_t::separating_6:  return "6-separating";
+    }
+    return "unknown";
+  }
+
+  // Loads a model file, or every file of a manifest, with or without textures
+  static bool load_scene(const std::string& filename, oasis::scene& scene, bool textures = true) {
+    if (is_manifest(filename)) {
+      // Manifest: many files, loaded in parallel and merged
+      auto start = std::chrono::high_resolution_clock::now();
+      if (!scene.load_manifest(filename, 0, textures)) {
+        std::cerr << "Failed to create scene from manifest: " << filename << std::endl;
+        return false;
+      }
+      auto elapsed = std::chrono::high_resolution_clock::now() - start;
+      std::cout << "Time to load and merge: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms" << std::endl;
+      return true;
+    }
+
     if (!scene.load(filename)) {
       std::cerr << "Failed to create scene from: " << filename << std::endl;
       return false;
     }
+    if (!textures) {
+      return true;
+    }
 
     const std::string input_dir = std::filesystem::path(filename).parent_path().string();
     if (!scene.load_textures(input_dir)) {
       std::cerr << "failed to create texures" << input_dir << std::endl;
     }
+    return true;
+  }
 
+  // Empty mode: library builder. Otherwise "conservative", "26", "6" or "compare".
+  // Builds the scene over its bounding cube, with the library builder or a voxelizer mode.
+  // Voxelizer modes fill `attributes`, if given, with each voxel's normal and material.
+  bool build_scene(oasis::scene& scene, uint8_t depth, const std::string& mode, oasis::voxel_attributes* attributes = nullptr) {
     glm::vec3 min, max;
     scene.get_bounds(min, max);
 
     glm::vec3 size = max - min;
     float max_size = glm::max(glm::max(size.x, size.y), size.z);
     
+    if (mode.empty()) {
+      auto start = std::chrono::high_resolution_clock::now();
+      build(&scene, depth, min, max_size);
+      auto elapsed = std::chrono::high_resolution_clock::now() - start;
+      std::cout << "Time to voxelize: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms" << std::endl;
+      std::cout << "DAG nodes: " << get_nodes().size() << std::endl;
+    } else {
+      // "compare" builds every mode; the conservative build runs last and is written
+      std::vector<oasis::voxelization_mode_t> modes;
+      if (mode == "compare") {
+        modes = {oasis::voxelization_mode_t::separating_6, 
+                 oasis::voxelization_mode_t::separating_26, 
+                 oasis::voxelization_mode_t::conservative};
+      } else if (mode == "conservative") {
+        modes = {oasis::voxelization_mode_t::conservative};
+      } else if (mode == "26") {
+        modes = {oasis::voxelization_mode_t::separating_26};
+      } else if (mode == "6") {
+        modes = {oasis::voxelization_mode_t::separating_6};
+      } else {
+        std::cerr << "Unknown voxelization mode: " << mode << std::endl;
+        return false;
+      }
+
+      for (auto m : modes) {
+        auto stats = voxelize(&scene, depth, min, max_size, m, attributes);
+        std::cout << "Mode " << mode_name(m) 
+                  << ": " << stats.build_ms << " ms, " 
+                  << stats.nodes << " DAG nodes, " 
+                  << stats.voxels << " voxels" << std::endl;
+      }
+    }
+    return true;
+  }
+
+  // Voxelizer modes sample textures through a texture_cache ("rgba8" or "bc1",
+  // optionally ":<budget MB>") that loads them on first use, so the scene
+  // never holds them, or through a texture_atlas ("atlas") packed from the
+  // scene's textures, which are then released. The library builder reads
+  // them from the scene.
+  bool create(const std::string filename, const std::string out_filename, uint8_t depth, const std::string mode = "", 
+              const std::string textures = "") {
+    const std::string format = textures.substr(0, textures.find(':'));
+    const size_t budget_mb = textures.find(':') != std::string::npos ? std::strtoull(textures.c_str() + textures.find(':') + 1, nullptr, 10) : 0;
+    if (!format.empty() && format != "rgba8" && format != "bc1" && format != "atlas") {
+      std::cerr << "Unknown texture storage: " << textures << std::endl;
+      return false;
+    }
+    const bool voxelizer = !mode.empty();
+    const bool atlas_textures = voxelizer && format == "atlas";
+    oasis::scene scene;
+    if (!load_scene(filename, scene, !voxelizer || atlas_textures)) {
+      return false;
+    }
+
+    oasis::texture_cache cache(budget_mb << 20, format == "bc1" ? oasis::texture_format_t::bc1 : oasis::texture_format_t::rgba8);
+    oasis::texture_atlas atlas;
+    if (atlas_textures) {
+      const size_t images = atlas.build(std::move(scene.m_textures));
+      scene.m_textures.clear();
+      std::cout << "Texture atlas: " << images << " unique images in " << atlas.get_pages().size() << " pages, " 
+                << atlas.memory_usage() / (1 << 20) << " MB" << std::endl;
+      use_texture_atlas(&atlas);
+    } else if (voxelizer) {
+      // Manifest materials already name absolute paths
+      cache.add_materials(scene.m_materials, std::filesystem::path(filename).parent_path().string());
+      use_texture_cache(&cache);
+    }
+    oasis::voxel_attributes attributes;
+    const bool built = build_scene(scene, depth, mode, voxelizer ? &attributes : nullptr);
+    use_texture_cache(nullptr);
+    if (!built) {
+      return false;
+    }
+    if (voxelizer && !atlas_textures) {
+      const auto stats = cache.get_stats();
+      std::cout << "Texture memory: " << cache.memory_usage() / (1 << 20) << " MB resident, " 
+                << stats.loads << " loads, " << stats.evictions << " evictions" << std::endl;
+    }
+
+    // Written behind: the scene is released while the file is being written
+    oasis::node_pool_writer writer;
+    auto written = writer.submit(out_filename, std::move(get_nodes()));
+    scene = oasis::scene();
+    auto result = written.get();
+    get_nodes() = std::move(result.nodes);
+    if (result.ok) {
+      std::cout << "Time to write: " << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::duration<double, std::milli>(result.ms)).count() << " ms (" 
+                << result.mb_per_s() << " MB/s)" << std::endl;
+    } else {
+      std::cerr << "Failed to write SVDAG file." << std::endl;
+    }
+
+    // Voxel normals and materials go next to the pool
+    if (voxelizer) {
+      if (attributes.size() > 0 && attributes.write(out_filename + ".attr")) {
+        std::cout << "Attributes: " << attributes.size() << " voxels, " 
+                  << attributes.stream_bytes() / 1024 << " KB stream (" << out_filename << ".attr)" << std::endl;
+      } else {
+        std::cerr << "Failed to write voxel attributes." << std::endl;
+      }
+    }
+    return true;
+  }
+
+  // Sequence: one frame's input file per line. Every frame is built over the
+  // bounding cube of all frames, in parallel, into one shared pool.
+  bool create_sequence(const std::string frame_list, const std::string out_filename, int depth, size_t threads) {
+    std::ifstream in(frame_list);
+    if (!in) {
+      std::cerr << "Failed to open frame list: " << frame_list << std::endl;
+      return false;
+    }
+    std::vector<std::string> frames;
+    for (std::string line; std::getline(in, line);) {
+      line = line.substr(0, line.find('#'));
+      std::istringstream ls(line);
+      std::string input;
+      if (ls >> input) {
+        frames.push_back(input);
+      }
+    }
+
+    // Common bounds, so the same voxel means the same place in every frame
     auto start = std::chrono::high_resolution_clock::now();
-    build(&scene, depth, min, max_size);
+    glm::vec3 min(std::numeric_limits<float>::max()), max(-std::numeric_limits<float>::max());
+    for (const auto& input : frames) {
+      oasis::scene scene;
+      if (!scene.load(input)) {
+        std::cerr << "Failed to create scene from: " << input << std::endl;
+        return false;
+      }
+      glm::vec3 lo, hi;
+      scene.get_bounds(lo, hi);
+      min = glm::min(min, lo);
+      max = glm::max(max, hi);
+    }
+    const glm::vec3 size = max - min;
+    const float max_size = glm::max(glm::max(size.x, size.y), size.z);
+
+    std::atomic<size_t> independent{0};
+    const bool ok = build_sequence(frames.size(), [&](size_t f, std::vector<oasis::node_t<int>>& nodes) {
+      oasis::scene scene;
+      if (!load_scene(frames[f], scene)) {
+        return false;
+      }
+      dag_node_pool frame_pool;
+      frame_pool.build(&scene, depth, min, max_size);
+      nodes = std::move(frame_pool.get_nodes());
+      independent += nodes.size();
+      return true;
+    }, threads);
     auto elapsed = std::chrono::high_resolution_clock::now() - start;
-    std::cout << "Time to voxelize: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms" << std::endl;
-    std::cout << "DAG nodes: " << get_nodes().size() << std::endl;
 
-    std::ofstream out_file(out_filename, std::ios::binary);
-    if (out_file) {
-      size_t voxel_count = get_nodes().size();
-      out_file.write(reinterpret_cast<const char*>(&voxel_count), sizeof(voxel_count));
-      out_file.write(reinterpret_cast<const char*>(get_nodes().data()), voxel_count * sizeof(oasis::node_t<int>));
-      out_file.close();
+    std::cout << "Frames: " << frame_count() << std::endl;
+    std::cout << "Nodes in separate frame pools: " << independent << std::endl;
+    std::cout << "Nodes in the shared pool: " << get_nodes().size() << std::endl;
+    std::cout << "Time to build: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms" << std::endl;
+    if (!write_sequence(out_filename)) {
+      std::cerr << "Failed to write sequence file: " << out_filename << std::endl;
+      return false;
+    }
+    return ok;
+  }
+
+  // Batch: "input output depth [mode]" per line. Loading job N+1, building N
+  // and writing N-1 overlap; at most `queue_depth` jobs wait between stages.
+  // This pool (and its voxelizer/dedup capacity) builds every job, and node
+  // buffers come back from the writer for reuse instead of reallocating.
+  bool create_batch(const std::string job_list, size_t queue_depth) {
+    struct job_t {
+      std::string input, output, mode;
+      int         depth = 0;
+      bool        ok = false;
+      double      load_ms = 0, build_ms = 0, write_ms = 0;
+      size_t      nodes = 0;
+    };
+
+    std::ifstream in(job_list);
+    if (!in) {
+      std::cerr << "Failed to open job list: " << job_list << std::endl;
+      return false;
+    }
+    std::vector<job_t> jobs;
+    for (std::string line; std::getline(in, line);) {
+      line = line.substr(0, line.find('#'));
+      std::istringstream ls(line);
+      job_t job;
+      if (!(ls >> job.input >> job.output >> job.depth)) {
+        continue;
+      }
+      ls >> job.mode;
+      jobs.push_back(job);
+    }
+
+    struct loaded_t { size_t job; std::unique_ptr<oasis::scene> scene; };
+    struct written_t { size_t job; std::future<oasis::pool_write_result_t> result; };
+    bounded_queue<loaded_t> loaded(queue_depth);
+    std::deque<written_t> in_flight;
+    std::vector<std::vector<oasis::node_t<int>>> spare;
+    oasis::node_pool_writer writer;
+
+    auto ms_since = [](auto start) {
+      return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Collects the oldest write and keeps its node buffer for a later build
+    auto retire = [&]() {
+      auto item = std::move(in_flight.front());
+      in_flight.pop_front();
+      auto result = item.result.get();
+      auto& job = jobs[item.job];
+      job.ok = result.ok;
+      job.write_ms = result.ms;
+      if (!job.ok) {
+        std::cerr << "Failed to write SVDAG file: " << job.output << std::endl;
+      }
+      result.nodes.clear();
+      spare.push_back(std::move(result.nodes));
+    };
+
+    std::thread loader([&]() {
+      for (size_t i = 0; i < jobs.size(); ++i) {
+        auto t = std::chrono::high_resolution_clock::now();
+        auto scene = std::make_unique<oasis::scene>();
+        if (!load_scene(jobs[i].input, *scene)) {
+          scene.reset();
+        }
+        jobs[i].load_ms = ms_since(t);
+        loaded.push({i, std::move(scene)});
+      }
+      loaded.close();
+    });
+
+    while (auto item = loaded.pop()) {
+      auto& job = jobs[item->job];
+      if (!item->scene) {
+        continue;
+      }
+      auto t = std::chrono::high_resolution_clock::now();
+      const bool ok = build_scene(*item->scene, uint8_t(job.depth), job.mode);
+      job.build_ms = ms_since(t);
+      item->scene.reset();
+      if (!ok) {
+        continue;
+      }
+
+      // Hand the nodes to the writer and keep building into a recycled buffer
+      while (in_flight.size() >= std::max<size_t>(1, queue_depth) || 
+             (!in_flight.empty() && in_flight.front().result.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+        retire();
+      }
+      std::vector<oasis::node_t<int>> nodes;
+      if (!spare.empty()) {
+        nodes = std::move(spare.back());
+        spare.pop_back();
+      }
+      std::swap(nodes, get_nodes());
+      job.nodes = nodes.size();
+      in_flight.push_back({item->job, writer.submit(job.output, std::move(nodes))});
+    }
+    while (!in_flight.empty()) {
+      retire();
+    }
+    loader.join();
+
+    size_t failed = 0;
+    std::cout << "Batch jobs (load / build / write ms, nodes):" << std::endl;
+    for (const auto& job : jobs) {
+      std::cout << "  " << job.input << " -> " << job.output << ": ";
+      if (job.ok) {
+        std::cout << job.load_ms << " / " << job.build_ms << " / " << job.write_ms << ", " << job.nodes << std::endl;
+      } else {
+        std::cout << "failed" << std::endl;
+        ++failed;
+      }
+    }
+    std::cout << "Batch time: " << ms_since(start) << " ms, " << jobs.size() - failed << " of " << jobs.size() << " jobs done" << std::endl;
+    std::cout << "Write throughput: " << writer.throughput() << " MB/s" << std::endl;
+    return failed == 0;
+  }
+
+  // Times the float and fixed-point ray kernels on pools built at each depth
+  bool bench_traversal(const std::string filename, int min_depth, int max_depth, size_t ray_count) {
+    oasis::scene scene;
+    if (!load_scene(filename, scene)) {
+      return false;
+    }
+
+    glm::vec3 min, max;
+    scene.get_bounds(min, max);
+    glm::vec3 size = max - min;
+    float max_size = glm::max(glm::max(size.x, size.y), size.z);
+    const glm::vec3 center = min + size * 0.5f;
+
+    // Rays from a sphere around the scene towards random points inside it
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<std::pair<glm::vec3, glm::vec3>> rays(ray_count);
+    for (auto& [o, d] : rays) {
+      glm::vec3 dir;
+      do {
+        dir = glm::vec3(unit(rng), unit(rng), unit(rng));
+      } while (glm::length(dir) < 0.1f || glm::length(dir) > 1.0f);
+      o = center + glm::normalize(dir) * max_size * 1.5f;
+      const glm::vec3 target = center + glm::vec3(unit(rng), unit(rng), unit(rng)) * size * 0.5f;
+      d = glm::normalize(target - o);
+    }
+
+    // A picking sweep: scanline-ordered rays from one eye, for the restart context
+    std::vector<glm::vec3> sweep;
+    const glm::vec3 eye = center + glm::vec3(0.3f, 0.4f, 1.0f) * max_size * 1.5f;
+    for (int y = 0; y < 256; ++y) {
+      for (int x = 0; x < 256; ++x) {
+        const glm::vec3 target = min + glm::vec3(x / 255.0f, y / 255.0f, 0.5f) * size;
+        sweep.push_back(glm::normalize(target - eye));
+      }
+    }
+
+    std::cout << "depth, nodes, library Mrays/s, library hit mismatches, float Mrays/s, fixed Mrays/s, hits, mismatches, " 
+              << "sweep fetches (root), sweep fetches (restart), " 
+              << "sensor cache hit rate, sensor saved fetches, sensor mismatches, get_node Mlookups/s, view Mlookups/s, " 
+              << "implicit top Mrays/s, implicit top Mlookups/s" << std::endl;
+    for (int depth = min_depth; depth <= max_depth; ++depth) {
+      voxelize(&scene, depth, min, max_size);
+      const oasis::pool_frame_t frame{min, max_size, uint32_t(depth)};
+      const float voxel = max_size / float(1u << depth);
+
+      std::vector<float> float_t(rays.size()), fixed_t(rays.size());
+      auto start = std::chrono::high_resolution_clock::now();
+      for (size_t i = 0; i < rays.size(); ++i) {
+        float_t[i] = oasis::query_ray(get_nodes(), frame, rays[i].first, rays[i].second, 1e30f).value_or(-1.0f);
+      }
+      const double float_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+      start = std::chrono::high_resolution_clock::now();
+      for (size_t i = 0; i < rays.size(); ++i) {
+        fixed_t[i] = oasis::query_ray_fixed(get_nodes(), frame, rays[i].first, rays[i].second, 1e30f).value_or(-1.0f);
+      }
+      const double fixed_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+      // The library's float kernel traces in the pool's unit cube
+      std::vector<char> library_hit(rays.size());
+      start = std::chrono::high_resolution_clock::now();
+      for (size_t i = 0; i < rays.size(); ++i) {
+        library_hit[i] = traversal((rays[i].first - min) / max_size, rays[i].second, uint32_t(depth), 1e30f).has_value();
+      }
+      const double library_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+      size_t hits = 0, mismatches = 0, library_mismatches = 0;
+      for (size_t i = 0; i < rays.size(); ++i) {
+        hits += fixed_t[i] >= 0.0f;
+        mismatches += (float_t[i] < 0.0f) != (fixed_t[i] < 0.0f) || std::abs(float_t[i] - fixed_t[i]) > 2.0f * voxel;
+        library_mismatches += bool(library_hit[i]) != (fixed_t[i] >= 0.0f);
+      }
+      oasis::traversal_context cold(get_nodes(), frame), warm(get_nodes(), frame);
+      size_t cold_fetches = 0;
+      for (const auto& d : sweep) {
+        cold.reset();
+        const auto a = cold.trace(eye, d, 1e30f);
+        cold_fetches += cold.fetches();
+        mismatches += a != warm.trace(eye, d, 1e30f);
+      }
+
+      // The sweep as a sensor over 16 frames with the eye drifting by a voxel every 4th frame
+      oasis::hit_cache cache(get_nodes(), frame, 1.5f * voxel);
+      size_t cache_mismatches = 0;
+      for (int f = 0; f < 16; ++f) {
+        const glm::vec3 o = eye + glm::vec3(voxel, 0.0f, 0.0f) * float(f / 4);
+        for (size_t i = 0; i < sweep.size(); ++i) {
+          cache_mismatches += cache.trace(i, o, sweep[i], 1e30f) != oasis::query_ray_fixed(get_nodes(), frame, o, sweep[i], 1e30f);
+        }
+      }
+
+      // Voxel lookups through the library accessors, then through an inline view
+      const uint32_t side = 1u << depth;
+      std::vector<glm::uvec3> voxels(rays.size());
+      for (auto& v : voxels) {
+        v = glm::uvec3(rng() % side, rng() % side, rng() % side);
+      }
+      int64_t checked_sum = 0, view_sum = 0;
+      start = std::chrono::high_resolution_clock::now();
+      for (const auto& v : voxels) {
+        int node = 0, child = 0;
+        for (uint32_t level = depth; level-- > 0;) {
+          child = get_node(node).value(oasis::child_slot(v.x >> level, v.y >> level, v.z >> level));
+          if (child <= 0) break;
+          node = child - 1;
+        }
+        checked_sum += child > 0 ? 0 : child;
+      }
+      const double checked_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+      // The inline slot extract must agree with the library's
+      for (const auto& v : voxels) {
+        const uint32_t shift = v.x % uint32_t(depth);
+        mismatches += oasis::extract_child_slot_bfe(v, shift) != oasis::child_slot_bfe(v, shift);
+      }
+
+      start = std::chrono::high_resolution_clock::now();
+      const oasis::node_pool_view<> view(*this);
+      for (const auto& v : voxels) {
+        view_sum += view.lookup(v, depth);
+      }
+      const double view_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+      mismatches += checked_sum != view_sum;
+
+      // The same rays and lookups with the top levels stored implicitly
+      const oasis::implicit_top_levels top(get_nodes(), depth, 4);
+      start = std::chrono::high_resolution_clock::now();
+      for (size_t i = 0; i < rays.size(); ++i) {
+        mismatches += oasis::query_ray(top, frame, rays[i].first, rays[i].second, 1e30f).value_or(-1.0f) != fixed_t[i];
+      }
+      const double top_ray_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+      int64_t top_sum = 0;
+      start = std::chrono::high_resolution_clock::now();
+      for (const auto& v : voxels) {
+        top_sum += top.lookup(v);
+      }
+      const double top_lookup_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+      mismatches += top_sum != view_sum;
+
+      std::cout << depth << ", " << get_nodes().size() << ", " 
+                << rays.size() / library_ms / 1e3 << ", " << library_mismatches << ", " 
+                << rays.size() / float_ms / 1e3 << ", " << rays.size() / fixed_ms / 1e3 << ", " 
+                << hits << ", " << mismatches << ", " << cold_fetches << ", " << warm.fetches() << ", " 
+                << cache.stats().hit_rate() << ", " << cache.stats().saved_fetches << ", " << cache_mismatches << ", " 
+                << voxels.size() / checked_ms / 1e3 << ", " << voxels.size() / view_ms / 1e3 << ", " 
+                << rays.size() / top_ray_ms / 1e3 << ", " << voxels.size() / top_lookup_ms / 1e3 << std::endl;
+    }
+    return true;
+  }
+
+  // Times primary rays with and without the beam prepass from a few orbit views
+  bool bench_beam(const std::string filename, int depth, uint32_t width, uint32_t height, uint32_t tile) {
+    oasis::scene scene;
+    if (!load_scene(filename, scene)) {
+      return false;
+    }
+
+    glm::vec3 min, max;
+    scene.get_bounds(min, max);
+    glm::vec3 size = max - min;
+    float max_size = glm::max(glm::max(size.x, size.y), size.z);
+    const glm::vec3 center = min + size * 0.5f;
+
+    auto stats = voxelize(&scene, depth, min, max_size);
+    std::cout << "DAG nodes: " << stats.nodes << std::endl;
+    const oasis::pool_frame_t frame{min, max_size, uint32_t(depth)};
+
+    std::cout << "view, plain ms, beam ms, speedup, hits, mismatches, visible nodes, cull ms" << std::endl;
+    for (int view = 0; view < 4; ++view) {
+      const float angle = 0.6f + view * 1.5707963f;
+      oasis::camera_t camera;
+      camera.eye = center + glm::vec3(std::cos(angle), 0.35f, std::sin(angle)) * max_size * 1.2f;
+      camera.forward = center - camera.eye;
+      camera.width = width;
+      camera.height = height;
+
+      auto start = std::chrono::high_resolution_clock::now();
+      const auto plain = oasis::trace_primary(get_nodes(), frame, camera, 1e30f, 0);
+      const double plain_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+      start = std::chrono::high_resolution_clock::now();
+      const auto beam = oasis::trace_primary(get_nodes(), frame, camera, 1e30f, tile);
+      const double beam_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+      const float voxel = max_size / float(1u << depth);
+      size_t hits = 0, mismatches = 0;
+      for (size_t i = 0; i < plain.size(); ++i) {
+        hits += plain[i] >= 0.0f;
+        mismatches += (plain[i] < 0.0f) != (beam[i] < 0.0f) || std::abs(plain[i] - beam[i]) > voxel;
+      }
+      // Nodes a streaming client needs for this view at one pixel of error
+      start = std::chrono::high_resolution_clock::now();
+      const auto visible = oasis::visible_nodes(get_nodes(), frame, camera, 1.0f);
+      const double cull_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+      std::cout << view << ", " << plain_ms << ", " << beam_ms << ", " << plain_ms / beam_ms << ", " 
+                << hits << ", " << mismatches << ", " << visible.size() << ", " << cull_ms << std::endl;
+    }
+    return true;
+  }
+
+  // Times "can A see B" checks between agents standing in empty space: one
+  // query_ray_fixed per pair against the batched line_of_sight
+  bool bench_los(const std::string filename, int depth, size_t pair_count) {
+    oasis::scene scene;
+    if (!load_scene(filename, scene)) {
+      return false;
+    }
+
+    glm::vec3 min, max;
+    scene.get_bounds(min, max);
+    glm::vec3 size = max - min;
+    float max_size = glm::max(glm::max(size.x, size.y), size.z);
+
+    auto stats = voxelize(&scene, depth, min, max_size);
+    std::cout << "DAG nodes: " << stats.nodes << std::endl;
+    const oasis::pool_frame_t frame{min, max_size, uint32_t(depth)};
+
+    // Agents at random empty points; each checks a few dozen others, as an AI tick would
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<glm::vec3> agents;
+    for (size_t tries = 0; agents.size() < 1024 && tries < 1000000; ++tries) {
+      const glm::vec3 p = min + glm::vec3(unit(rng), unit(rng), unit(rng)) * size;
+      if (oasis::query_point(get_nodes(), frame, p) == 0) {
+        agents.push_back(p);
+      }
+    }
+    if (agents.size() < 2) {
+      std::cerr << "No empty space to place agents in" << std::endl;
+      return false;
+    }
+    std::vector<std::pair<glm::vec3, glm::vec3>> pairs(pair_count);
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      const size_t a = (i / 32) % agents.size();
+      size_t b = rng() % agents.size();
+      if (b == a) b = (b + 1) % agents.size();
+      pairs[i] = {agents[a], agents[b]};
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<bool> single(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      const auto& [a, b] = pairs[i];
+      const float dist = glm::length(b - a);
+      single[i] = !oasis::query_ray_fixed(get_nodes(), frame, a, (b - a) / dist, dist);
+    }
+    const double single_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "threads, ms, Mpairs/s, visible, mismatches" << std::endl;
+    std::cout << "per pair, " << single_ms << ", " << pairs.size() / single_ms / 1000.0 << ", " 
+              << std::count(single.begin(), single.end(), true) << ", 0" << std::endl;
+    for (uint32_t threads : {1u, std::max(1u, std::thread::hardware_concurrency())}) {
+      start = std::chrono::high_resolution_clock::now();
+      const auto bits = oasis::line_of_sight(get_nodes(), frame, pairs, threads);
+      const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+      size_t mismatches = 0;
+      for (size_t i = 0; i < pairs.size(); ++i) {
+        mismatches += bits.visible(i) != single[i];
+      }
+      std::cout << threads << ", " << ms << ", " << pairs.size() / ms / 1000.0 << ", " 
+                << bits.count() << ", " << mismatches << std::endl;
+    }
+    return true;
+  }
+
+  // Records a node access profile along a camera path, then replays the path
+  // over a depth-first and a profile-guided layout of the same pool.
+  // Path file: "eye_x eye_y eye_z target_x target_y target_z" per line; without
+  // one, a 64-frame orbit around the scene is used.
+  bool bench_layout(const std::string filename, int depth, const std::string path_file) {
+    oasis::scene scene;
+    if (!load_scene(filename, scene)) {
+      return false;
+    }
+
+    glm::vec3 min, max;
+    scene.get_bounds(min, max);
+    glm::vec3 size = max - min;
+    float max_size = glm::max(glm::max(size.x, size.y), size.z);
+    const glm::vec3 center = min + size * 0.5f;
+
+    auto stats = voxelize(&scene, depth, min, max_size);
+    std::cout << "DAG nodes: " << stats.nodes << std::endl;
+    const oasis::pool_frame_t frame{min, max_size, uint32_t(depth)};
+
+    std::vector<oasis::camera_t> path;
+    if (!path_file.empty()) {
+      std::ifstream in(path_file);
+      if (!in) {
+        std::cerr << "Failed to open camera path: " << path_file << std::endl;
+        return false;
+      }
+      for (std::string line; std::getline(in, line);) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream ls(line);
+        oasis::camera_t camera;
+        glm::vec3 target;
+        if (ls >> camera.eye.x >> camera.eye.y >> camera.eye.z >> target.x >> target.y >> target.z) {
+          camera.forward = target - camera.eye;
+          path.push_back(camera);
+        }
+      }
     } else {
+      for (int i = 0; i < 64; ++i) {
+        const float angle = 0.1f * float(i);
+        oasis::camera_t camera;
+        camera.eye = center + glm::vec3(std::cos(angle), 0.35f, std::sin(angle)) * max_size * 1.2f;
+        camera.forward = center - camera.eye;
+        path.push_back(camera);
+      }
+    }
+    for (auto& camera : path) {
+      camera.width = 320;
+      camera.height = 240;
+    }
+
+    // Traces every frame of the path with one traversal context per thread
+    const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    auto replay = [&](std::span<const oasis::node_t<int>> nodes, std::vector<oasis::access_counter>* counters) {
+      std::vector<std::thread> workers;
+      std::atomic<size_t> hits{0};
+      for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+          oasis::traversal_context context(nodes, frame);
+          if (counters) {
+            (*counters)[t].attach(context);
+          }
+          size_t local = 0;
+          for (size_t f = t; f < path.size(); f += threads) {
+            const auto& camera = path[f];
+            for (uint32_t y = 0; y < camera.height; ++y) {
+              for (uint32_t x = 0; x < camera.width; ++x) {
+                local += bool(context.trace(camera.eye, camera.direction(x + 0.5f, y + 0.5f), 1e30f));
+              }
+            }
+          }
+          hits += local;
+        });
+      }
+      for (auto& worker : workers) {
+        worker.join();
+      }
+      return hits.load();
+    };
+
+    // Average 4 KiB pages of the node array one frame touches
+    auto pages_per_frame = [&](std::span<const oasis::node_t<int>> nodes) {
+      const size_t per_page = 4096 / sizeof(oasis::node_t<int>);
+      std::vector<uint32_t> counts(nodes.size());
+      size_t pages = 0;
+      for (const auto& camera : path) {
+        std::fill(counts.begin(), counts.end(), 0u);
+        oasis::traversal_context context(nodes, frame);
+        context.profile(counts.data());
+        for (uint32_t y = 0; y < camera.height; ++y) {
+          for (uint32_t x = 0; x < camera.width; ++x) {
+            context.trace(camera.eye, camera.direction(x + 0.5f, y + 0.5f), 1e30f);
+          }
+        }
+        for (size_t p = 0; p < nodes.size(); p += per_page) {
+          pages += std::any_of(counts.begin() + p, counts.begin() + std::min(p + per_page, nodes.size()),
+                               [](uint32_t c) { return c > 0; });
+        }
+      }
+      return double(pages) / double(path.size());
+    };
+
+    const auto dfs = oasis::apply_order(get_nodes(), oasis::depth_first_order(get_nodes()));
+
+    // Record: sampled per-thread counters, merged afterwards
+    std::vector<oasis::access_counter> counters(threads, oasis::access_counter(dfs.size(), 8));
+    replay(dfs, &counters);
+    oasis::access_profile profile(dfs.size());
+    for (const auto& counter : counters) {
+      profile.merge(counter);
+    }
+    const auto order = oasis::profile_order(dfs, profile);
+    const auto guided = oasis::apply_order(dfs, order);
+    oasis::access_profile guided_profile = profile;
+    guided_profile.remap(order);
+
+    std::cout << "frames: " << path.size() << ", threads: " << threads << std::endl;
+    std::cout << "layout, ms, hits, pages per frame, pages for 90% of reads" << std::endl;
+    for (const bool use_profile : {false, true}) {
+      const auto& nodes = use_profile ? guided : dfs;
+      auto start = std::chrono::high_resolution_clock::now();
+      const size_t hits = replay(nodes, nullptr);
+      const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+      std::cout << (use_profile ? "profile" : "dfs") << ", " << ms << ", " << hits << ", " << pages_per_frame(nodes) << ", "
+                << (use_profile ? guided_profile : profile).pages_for_share(4096, 0.9) << std::endl;
+    }
+    return true;
+  }
+
+  // Applies the same random voxel edits with and without reference counts,
+  // then path-copying with a time-sliced collector run between frames
+  bool bench_edits(const std::string filename, int depth, size_t edits) {
+    std::vector<oasis::node_t<int>> nodes;
+    if (!oasis::read_pool_file(filename, nodes)) {
+      std::cerr << "Failed to read SVDAG file: " << filename << std::endl;
+      return false;
+    }
+
+    constexpr size_t edits_per_frame = 64;
+    constexpr double gc_budget_us = 200.0;
+
+    // Expected values after the edits: the last value written, else the original pool's
+    const uint32_t side = 1u << depth;
+    const oasis::pool_frame_t frame{glm::vec3(0.0f), float(side), uint32_t(depth)};
+    std::vector<std::pair<glm::uvec3, int>> samples;
+    {
+      std::unordered_map<uint64_t, size_t> edited;
+      std::mt19937 rng(99);
+      for (size_t i = 0; i < edits; ++i) {
+        const glm::uvec3 voxel(rng() % side, rng() % side, rng() % side);
+        const int value = rng() % 4 == 0 ? 0 : -int(1 + rng() % 255);
+        const uint64_t key = uint64_t(voxel.x) | uint64_t(voxel.y) << 21 | uint64_t(voxel.z) << 42;
+        auto [it, inserted] = edited.try_emplace(key, samples.size());
+        if (inserted) {
+          samples.emplace_back(voxel, value);
+        } else {
+          samples[it->second].second = value;
+        }
+      }
+      std::mt19937 other(7);
+      for (size_t i = 0; i < 4096; ++i) {
+        const glm::uvec3 voxel(other() % side, other() % side, other() % side);
+        const uint64_t key = uint64_t(voxel.x) | uint64_t(voxel.y) << 21 | uint64_t(voxel.z) << 42;
+        if (!edited.count(key)) {
+          samples.emplace_back(voxel, oasis::query_point(nodes, frame, glm::vec3(voxel) + 0.5f));
+        }
+      }
+    }
+
+    bool ok = true;
+    std::cout << "mode, ms, nodes, in place, copies, reused slots, free slots, gc cycles, max gc slice us, mismatches" << std::endl;
+    for (const std::string mode : {"copy", "refcounts", "gc"}) {
+      // A new pool: no free slot or collector state may carry over from the last run
+      get_nodes() = nodes;
+      reset_allocator();
+      if (mode == "refcounts") {
+        track_references();
+      } else {
+        untrack_references();
+      }
+      reset_stats();
+      reset_gc_stats();
+
+      std::mt19937 rng(99);
+      auto start = std::chrono::high_resolution_clock::now();
+      for (size_t i = 0; i < edits; ++i) {
+        const glm::uvec3 voxel(rng() % side, rng() % side, rng() % side);
+        set_voxel(voxel, depth, rng() % 4 == 0 ? 0 : -int(1 + rng() % 255));
+        if (mode == "gc" && i % edits_per_frame == edits_per_frame - 1) {
+          gc_step(gc_budget_us);
+        }
+      }
+      const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+      size_t mismatches = 0;
+      for (const auto& [voxel, value] : samples) {
+        mismatches += oasis::query_point(get_nodes(), frame, glm::vec3(voxel) + 0.5f) != value;
+      }
+      ok = ok && mismatches == 0;
+      std::cout << mode << ", " << ms << ", " << get_nodes().size() << ", " 
+                << stats().in_place << ", " << stats().copies << ", " << stats().reused << ", " << garbage() << ", " 
+                << gc_stats().cycles << ", " << gc_stats().max_slice_us << ", " << mismatches << std::endl;
+    }
+    return ok;
+  }
+
+  // Writes a pool in the compact encoding and checks that rays traced on the
+  // encoding in place match rays traced on the expanded nodes
+  bool create_compact(const std::string filename, const std::string out_filename, int depth, size_t ray_count) {
+    std::vector<oasis::node_t<int>> nodes;
+    if (!oasis::read_pool_file(filename, nodes)) {
+      std::cerr << "Failed to read SVDAG file: " << filename << std::endl;
+      return false;
+    }
+
+    // Parent-first order keeps child offsets short
+    nodes = oasis::apply_order(nodes, oasis::depth_first_order(nodes));
+    auto start = std::chrono::high_resolution_clock::now();
+    const oasis::compact_pool encoded(nodes);
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    if (encoded.size() != nodes.size()) {
+      std::cerr << "Pool exceeds the compact encoding's " << oasis::compact_pool::max_bytes << " bytes" << std::endl;
+      return false;
+    }
+    if (!encoded.write(out_filename)) {
+      std::cerr << "Failed to write compact file: " << out_filename << std::endl;
+      return false;
+    }
+    oasis::compact_pool compact;
+    if (!compact.read(out_filename) || compact.expand() != nodes) {
+      std::cerr << "Compact file does not round-trip: " << out_filename << std::endl;
+      return false;
+    }
+    std::cout << "Nodes: " << nodes.size() << std::endl;
+    std::cout << "Expanded bytes: " << nodes.size() * sizeof(oasis::node_t<int>) << std::endl;
+    std::cout << "Compact bytes: " << compact.memory_usage() << std::endl;
+    std::cout << "Time to encode: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms" << std::endl;
+
+    // Rays from around the unit cube the pool is served in
+    const oasis::pool_frame_t frame{glm::vec3(0.0f), 1.0f, uint32_t(depth)};
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<std::pair<glm::vec3, glm::vec3>> rays(ray_count);
+    for (auto& [o, d] : rays) {
+      o = glm::vec3(unit(rng), unit(rng), unit(rng)) * 3.0f - 1.0f;
+      d = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) - o);
+    }
+
+    size_t mismatches = 0;
+    std::vector<float> expanded_t(rays.size());
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < rays.size(); ++i) {
+      expanded_t[i] = oasis::query_ray_fixed(nodes, frame, rays[i].first, rays[i].second, 1e30f).value_or(-1.0f);
+    }
+    const double expanded_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < rays.size(); ++i) {
+      mismatches += oasis::query_ray(compact.view(), frame, rays[i].first, rays[i].second, 1e30f).value_or(-1.0f) != expanded_t[i];
+    }
+    const double compact_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "Expanded Mrays/s: " << rays.size() / expanded_ms / 1e3 << std::endl;
+    std::cout << "Compact Mrays/s: " << rays.size() / compact_ms / 1e3 << std::endl;
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    return mismatches == 0;
+  }
+
+  // Scatters a pool with reference-counted edits, then defragments it
+  // while reader threads keep looking up voxels and checking the results
+  bool bench_defrag(const std::string filename, int depth, size_t edits, size_t readers) {
+    if (!oasis::read_pool_file(filename, get_nodes())) {
+      std::cerr << "Failed to read SVDAG file: " << filename << std::endl;
+      return false;
+    }
+    track_references();
+
+    std::mt19937 rng(99);
+    const uint32_t side = 1u << depth;
+    for (size_t i = 0; i < edits; ++i) {
+      const glm::uvec3 voxel(rng() % side, rng() % side, rng() % side);
+      set_voxel(voxel, depth, rng() % 4 == 0 ? 0 : -int(1 + rng() % 255));
+    }
+
+    // Expected values of a fixed sample of voxels
+    const oasis::pool_frame_t frame{glm::vec3(0.0f), float(side), uint32_t(depth)};
+    std::vector<std::pair<glm::uvec3, int>> samples(1 << 16);
+    for (auto& [voxel, value] : samples) {
+      voxel = glm::uvec3(rng() % side, rng() % side, rng() % side);
+      value = oasis::query_point(get_nodes(), frame, glm::vec3(voxel) + 0.5f);
+    }
+
+    const double before = layout_locality();
+    reserve_for_readers(get_nodes().size());
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> lookups{0}, mismatches{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < readers; ++t) {
+      threads.emplace_back([&, t]() {
+        const size_t id = register_reader();
+        size_t k = t;
+        while (!stop.load(std::memory_order_relaxed)) {
+          read_guard guard(*this, id);
+          const auto nodes = reader_nodes();
+          for (size_t q = 0; q < 256; ++q, k += readers) {
+            const auto& [voxel, value] = samples[k % samples.size()];
+            int node = 0, child = 0;
+            for (uint32_t level = depth; level-- > 0;) {
+              child = oasis::read_child(nodes, node, oasis::child_slot(voxel.x >> level, voxel.y >> level, voxel.z >> level));
+              if (child <= 0) break;
+              node = child - 1;
+            }
+            mismatches += child != value;
+          }
+          lookups += 256;
+        }
+      });
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const size_t subtrees = defragment();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    stop = true;
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    reclaim();
+
+    std::cout << "locality before: " << before << std::endl;
+    std::cout << "locality after: " << layout_locality() << std::endl;
+    std::cout << "subtrees moved: " << subtrees << ", nodes moved: " << defrag_stats().moved 
+              << ", skipped (no room): " << defrag_stats().no_room << std::endl;
+    std::cout << "defrag ms: " << ms << ", reader lookups: " << lookups << ", mismatches: " << mismatches << std::endl;
+    return mismatches == 0;
+  }
+
+  // Worker: builds one tile of the scene's bounding cube at depth - level
+  bool create_tile(const std::string filename, const std::string out_filename, 
+                   int depth, int level, glm::uvec3 tile) {
+    oasis::scene scene;
+    if (!load_scene(filename, scene)) {
+      return false;
+    }
+
+    glm::vec3 min, max;
+    scene.get_bounds(min, max);
+    glm::vec3 size = max - min;
+    float max_size = glm::max(glm::max(size.x, size.y), size.z);
+
+    const float tile_size = oasis::node_pool_tiler::tile_size(max_size, level);
+    const glm::vec3 corner = oasis::node_pool_tiler::tile_corner(min, max_size, level, tile);
+    const glm::vec3 margin(tile_size * 1e-3f);
+    const size_t triangles = scene.crop(oasis::aabb_t(corner - margin, corner + glm::vec3(tile_size) + margin));
+
+    get_nodes().clear();
+    if (triangles > 0) {
+      build(&scene, depth - level, corner, tile_size);
+    }
+    if (!oasis::write_pool_file(out_filename, get_nodes())) {
+      std::cerr << "Failed to write tile file: " << out_filename << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  // Coordinator: runs one worker command per tile (jobs at a time, with retries)
+  // and assembles the tile pools with a global dedup pass.
+  // The template may use {exe} {input} {output} {depth} {level} {x} {y} {z}.
+  bool create_tiled(const std::string filename, const std::string out_filename, int depth, 
+                    int level, int jobs, int retries, const std::string exe, std::string command) {
+    if (level < 1 || level >= depth) {
+      std::cerr << "Tile level must be in [1, depth)" << std::endl;
+      return false;
+    }
+    if (command.empty()) {
+      command = "\"{exe}\" --worker \"{input}\" \"{output}\" {depth} {level} {x} {y} {z}";
+    }
+
+    struct tile_job_t {
+      glm::uvec3  tile;
+      std::string output;
+      int         attempts = 0;
+      double      ms = 0;
+      size_t      nodes = 0;
+      bool        ok = false;
+    };
+
+    const uint32_t side = 1u << level;
+    std::vector<tile_job_t> tiles;
+    for (uint32_t z = 0; z < side; ++z) {
+      for (uint32_t y = 0; y < side; ++y) {
+        for (uint32_t x = 0; x < side; ++x) {
+          tile_job_t job;
+          job.tile = glm::uvec3(x, y, z);
+          job.output = out_filename + ".tile_" + std::to_string(x) + "_" + std::to_string(y) + "_" + std::to_string(z);
+          tiles.push_back(job);
+        }
+      }
+    }
+
+    auto expand = [&](const tile_job_t& job) {
+      std::string cmd = command;
+      const std::pair<std::string, std::string> vars[] = {
+        {"{exe}", exe}, {"{input}", filename}, {"{output}", job.output},
+        {"{depth}", std::to_string(depth)}, {"{level}", std::to_string(level)},
+        {"{x}", std::to_string(job.tile.x)}, {"{y}", std::to_string(job.tile.y)}, {"{z}", std::to_string(job.tile.z)}};
+      for (const auto& [key, value] : vars) {
+        for (size_t pos = cmd.find(key); pos != std::string::npos; pos = cmd.find(key, pos + value.size())) {
+          cmd.replace(pos, key.size(), value);
+        }
+      }
+      return cmd;
+    };
+
+    std::atomic<size_t> next{0};
+    std::mutex log_mutex;
+    auto worker = [&]() {
+      for (size_t i = next++; i < tiles.size(); i = next++) {
+        auto& job = tiles[i];
+        const std::string cmd = expand(job);
+        while (!job.ok && job.attempts <= retries) {
+          ++job.attempts;
+          std::filesystem::remove(job.output);
+          auto start = std::chrono::high_resolution_clock::now();
+          const int status = std::system(cmd.c_str());
+          job.ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+          job.ok = status == 0 && std::filesystem::exists(job.output);
+          if (!job.ok) {
+            std::lock_guard<std::mutex> lock(log_mutex);
+            std::cerr << "Tile " << job.tile.x << "," << job.tile.y << "," << job.tile.z 
+                      << " failed (attempt " << job.attempts << ", status " << status << ")" << std::endl;
+          }
+        }
+      }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < std::max(1, jobs); ++t) {
+      pool.emplace_back(worker);
+    }
+    for (auto& t : pool) {
+      t.join();
+    }
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    std::cout << "Time to build tiles: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms" << std::endl;
+
+    for (const auto& job : tiles) {
+      if (!job.ok) {
+        std::cerr << "Giving up: tile " << job.tile.x << "," << job.tile.y << "," << job.tile.z 
+                  << " failed " << job.attempts << " times" << std::endl;
+        return false;
+      }
+    }
+
+    start = std::chrono::high_resolution_clock::now();
+    const bool assembled = assemble(level, [&](glm::uvec3 tile, std::vector<oasis::node_t<int>>& nodes) {
+      auto& job = tiles[(size_t(tile.z) * side + tile.y) * side + tile.x];
+      if (!oasis::read_pool_file(job.output, nodes)) {
+        return false;
+      }
+      job.nodes = nodes.size();
+      std::filesystem::remove(job.output);
+      return true;
+    });
+    elapsed = std::chrono::high_resolution_clock::now() - start;
+    if (!assembled) {
+      std::cerr << "Failed to read back tile pools." << std::endl;
+      return false;
+    }
+
+    std::cout << "Tile timings (x,y,z: ms, attempts, nodes):" << std::endl;
+    for (const auto& job : tiles) {
+      std::cout << "  " << job.tile.x << "," << job.tile.y << "," << job.tile.z << ": " 
+                << job.ms << " ms, " << job.attempts << ", " << job.nodes << std::endl;
+    }
+    std::cout << "Time to merge: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms" << std::endl;
+    std::cout << "DAG nodes: " << get_nodes().size() << std::endl;
+
+    if (!oasis::write_pool_file(out_filename, get_nodes())) {
       std::cerr << "Failed to write SVDAG file." << std::endl;
     }
     return true;
   }
 };
 
+static std::atomic<bool> g_stop{false};
+
+// Serves a pool file from shared memory until interrupted
+static bool serve_pool(const std::string filename, const std::string name, int depth, int clients, bool replace) {
+  std::vector<oasis::node_t<int>> nodes;
+  if (!oasis::read_pool_file(filename, nodes)) {
+    std::cerr << "Failed to read SVDAG file: " << filename << std::endl;
+    return false;
+  }
+
+  oasis::node_pool_server server;
+  const oasis::pool_frame_t frame{glm::vec3(0.0f), 1.0f, uint32_t(depth)};
+  if (!server.create(name, nodes, frame, uint32_t(clients), 4096, replace)) {
+    if (errno == EEXIST)
+      std::cerr << "Shared memory segment " << name << " already exists (another server running?); pass --replace to take it over" << std::endl;
+    else
+      std::cerr << "Failed to create shared memory segment: " << name << std::endl;
+    return false;
+  }
+  nodes = {};
+
+  std::signal(SIGINT, [](int) { g_stop = true; });
+  std::signal(SIGTERM, [](int) { g_stop = true; });
+  std::cout << "Serving " << filename << " as " << name << " (Ctrl-C to stop)" << std::endl;
+  server.serve(g_stop);
+  return true;
+}
+
 int main(int argc, char* argv[]) {
   std::string filename, out_filename;
   int depth;
 
+  // Tile worker, normally launched by --tiled
+  if (argc >= 9 && std::string(argv[1]) == "--worker") {
+    dag_node_pool d_pool;
+    const glm::uvec3 tile(std::atoi(argv[6]), std::atoi(argv[7]), std::atoi(argv[8]));
+    return d_pool.create_tile(argv[2], argv[3], std::atoi(argv[4]), std::atoi(argv[5]), tile) ? 0 : 1;
+  }
+
+  // Tiled build: --tiled <level> <jobs> <input> <output> <depth> [command template]
+  if (argc >= 7 && std::string(argv[1]) == "--tiled") {
+    dag_node_pool d_pool;
+    const int retries = 2;
+    const std::string command = argc > 7 ? argv[7] : "";
+    if (!d_pool.create_tiled(argv[4], argv[5], std::atoi(argv[6]), std::atoi(argv[2]), 
+                             std::atoi(argv[3]), retries, argv[0], command)) {
+      std::cout << "Failed to create: " << argv[4] << std::endl;
+      return 1;
+    }
+    std::cout << "Successfully created: " << argv[4] << std::endl;
+    return 0;
+  }
+
+  // Pool server: --serve <pool_file> <segment_name> <depth> [clients] [--replace]
+  if (argc >= 5 && std::string(argv[1]) == "--serve") {
+    const bool replace = std::string(argv[argc - 1]) == "--replace";
+    const int clients = argc > 5 && std::string(argv[5]) != "--replace" ? std::atoi(argv[5]) : 16;
+    return serve_pool(argv[2], argv[3], std::atoi(argv[4]), clients, replace) ? 0 : 1;
+  }
+
+  // Animated sequence: --sequence <frame_list> <output_filename> <depth> [threads]
+  if (argc >= 5 && std::string(argv[1]) == "--sequence") {
+    dag_node_pool d_pool;
+    return d_pool.create_sequence(argv[2], argv[3], std::atoi(argv[4]), argc > 5 ? std::atoi(argv[5]) : 0) ? 0 : 1;
+  }
+
+  // Batch: --batch <job_list> [queue_depth]
+  if (argc >= 3 && std::string(argv[1]) == "--batch") {
+    dag_node_pool d_pool;
+    return d_pool.create_batch(argv[2], argc > 3 ? std::atoi(argv[3]) : 2) ? 0 : 1;
+  }
+
+  // Ray kernel benchmark: --bench-traversal <input> <min_depth> <max_depth> [rays]
+  if (argc >= 5 && std::string(argv[1]) == "--bench-traversal") {
+    dag_node_pool d_pool;
+    const size_t rays = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 100000;
+    return d_pool.bench_traversal(argv[2], std::atoi(argv[3]), std::atoi(argv[4]), rays) ? 0 : 1;
+  }
+
+  // Beam prepass benchmark: --bench-beam <input> <depth> [width height tile]
+  if (argc >= 4 && std::string(argv[1]) == "--bench-beam") {
+    dag_node_pool d_pool;
+    const uint32_t width = argc > 4 ? std::atoi(argv[4]) : 1280;
+    const uint32_t height = argc > 5 ? std::atoi(argv[5]) : 720;
+    const uint32_t tile = argc > 6 ? std::atoi(argv[6]) : 8;
+    return d_pool.bench_beam(argv[2], std::atoi(argv[3]), width, height, tile) ? 0 : 1;
+  }
+
+  // Line-of-sight benchmark: --bench-los <input> <depth> [pairs]
+  if (argc >= 4 && std::string(argv[1]) == "--bench-los") {
+    dag_node_pool d_pool;
+    const size_t pairs = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 100000;
+    return d_pool.bench_los(argv[2], std::atoi(argv[3]), pairs) ? 0 : 1;
+  }
+
+  // Layout benchmark: --bench-layout <input> <depth> [camera_path]
+  if (argc >= 4 && std::string(argv[1]) == "--bench-layout") {
+    dag_node_pool d_pool;
+    return d_pool.bench_layout(argv[2], std::atoi(argv[3]), argc > 4 ? argv[4] : "") ? 0 : 1;
+  }
+
+  // Pool analytics: --analyze <svdag_file>
+  if (argc >= 3 && std::string(argv[1]) == "--analyze") {
+    std::vector<oasis::node_t<int>> nodes;
+    if (!oasis::read_pool_file(argv[2], nodes)) {
+      std::cerr << "Failed to read SVDAG file: " << argv[2] << std::endl;
+      return 1;
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    const auto report = oasis::analyze_pool(nodes);
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    oasis::write_pool_report(std::cout, report);
+    std::cout << "Time to analyze: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms" << std::endl;
+    return 0;
+  }
+
+  // Editing benchmark: --bench-edits <svdag_file> <depth> [edits]
+  if (argc >= 4 && std::string(argv[1]) == "--bench-edits") {
+    dag_node_pool d_pool;
+    const size_t edits = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 10000;
+    return d_pool.bench_edits(argv[2], std::atoi(argv[3]), edits) ? 0 : 1;
+  }
+
+  // Compact encoding: --compact <svdag_file> <output_file> <depth> [rays]
+  if (argc >= 5 && std::string(argv[1]) == "--compact") {
+    dag_node_pool d_pool;
+    const size_t rays = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 100000;
+    return d_pool.create_compact(argv[2], argv[3], std::atoi(argv[4]), rays) ? 0 : 1;
+  }
+
+  // Online defragmentation benchmark: --bench-defrag <svdag_file> <depth> [edits] [readers]
+  if (argc >= 4 && std::string(argv[1]) == "--bench-defrag") {
+    dag_node_pool d_pool;
+    const size_t edits = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 10000;
+    const size_t readers = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 4;
+    return d_pool.bench_defrag(argv[2], std::atoi(argv[3]), edits, readers) ? 0 : 1;
+  }
+
   if (argc < 4) {
-    std::cerr << "Usage: " << argv[0] << " <input_filename> <output_filename> <depth>" << std::endl;
+    std::cerr << "Usage: " << argv[0] << " <input_filename|manifest> <output_filename> <depth> [conservative|26|6|compare] [rgba8|bc1[:budget_mb]|atlas]" << std::endl;
+    std::cerr << "       " << argv[0] << " --tiled <tile_level> <jobs> <input_filename|manifest> <output_filename> <depth> [command template]" << std::endl;
+    std::cerr << "       " << argv[0] << " --batch <job_list> [queue_depth]" << std::endl;
+    std::cerr << "       " << argv[0] << " --sequence <frame_list> <output_filename> <depth> [threads]" << std::endl;
+    std::cerr << "       " << argv[0] << " --bench-traversal <input_filename|manifest> <min_depth> <max_depth> [rays]" << std::endl;
+    std::cerr << "       " << argv[0] << " --bench-beam <input_filename|manifest> <depth> [width height tile]" << std::endl;
+    std::cerr << "       " << argv[0] << " --bench-los <input_filename|manifest> <depth> [pairs]" << std::endl;
+    std::cerr << "       " << argv[0] << " --bench-layout <input_filename|manifest> <depth> [camera_path]" << std::endl;
+    std::cerr << "       " << argv[0] << " --analyze <svdag_filename>" << std::endl;
+    std::cerr << "       " << argv[0] << " --compact <svdag_filename> <output_filename> <depth> [rays]" << std::endl;
+    std::cerr << "       " << argv[0] << " --bench-edits <svdag_filename> <depth> [edits]" << std::endl;
+    std::cerr << "       " << argv[0] << " --bench-defrag <svdag_filename> <depth> [edits] [readers]" << std::endl;
+    std::cerr << "       " << argv[0] << " --serve <svdag_filename> <segment_name> <depth> [clients] [--replace]" << std::endl;
     return 1;
   }
 
   filename = argv[1];
   out_filename = argv[2];
   depth = std::atoi(argv[3]);
+  const std::string mode = argc > 4 ? argv[4] : "";
+  const std::string textures = argc > 5 ? argv[5] : "";
 
   std::cout << "Input file: " << filename << std::endl;
   std::cout << "Output file: " << out_filename << std::endl;
   std::cout << "Depth: " << depth << std::endl;
 
   dag_node_pool d_pool;
-  if (!d_pool.create(filename, out_filename, depth)) {
+  if (!d_pool.create(filename, out_filename, depth, mode, textures)) {
     std::cout << "Failed to create: " << filename << std::endl;
     return 1;
   }